@@ -0,0 +1,293 @@
+// Copyright (c) 2024 Thomas Klietsch, all rights reserved.
+//
+// Licensed under the GNU Lesser General Public License, version 3.0 or later
+//
+// This program is free software: you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation, either version 3 of
+// the License, or ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General
+// Public License along with this program.If not, see < https://www.gnu.org/licenses/>. 
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "./gauss_jordan.hpp"
+
+// Benchmarks of matrix construction, Solve, ErrorEstimate and SolveBatch.
+// Writes a JSON array with one object per measurement to std::cout
+namespace
+{
+
+	// Average time of one call, repeated until at least min_seconds have passed
+	template<typename Function>
+	double NanosecondsPerCall(
+		Function&& function,
+		double const& min_seconds = 0.2)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		function();
+		for (uint64_t repeats{ 1 };; repeats *= 2)
+		{
+			auto const start = Clock::now();
+			for (uint64_t i{ 0 }; i < repeats; ++i)
+				function();
+			std::chrono::duration<double> const elapsed = Clock::now() - start;
+
+			if (elapsed.count() >= min_seconds)
+				return elapsed.count() * 1e9 / repeats;
+		}
+	};
+
+	// Keeps the compiler from removing, or moving out of the timed loop,
+	// the computation of value and the memory it depends on
+	template<typename T>
+	void KeepAlive(
+		T const& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static T volatile sink;
+		sink = value;
+#endif
+	};
+
+	// Deterministic values in [-1, 1)
+	class Random final
+	{
+
+	private:
+
+		uint64_t state{ 0x2545F4914F6CDD1D };
+
+	public:
+
+		double next()
+		{
+			state = state * 6364136223846793005u + 1442695040888963407u;
+			return static_cast<double>(state >> 11) / static_cast<double>(1ull << 52) - 1;
+		};
+
+	};
+
+	// Row-major cells of a test matrix with a dominant diagonal.
+	// If reorder is set the diagonal is zero, so Solve has to search for a row
+	// order with a non-zero diagonal first. The matrix is then strictly lower
+	// triangular plus the top right cell, for which the first combination
+	// the search tries is valid, rows 1 to n_columns - 1 followed by row 0
+	template<typename T>
+	std::vector<T> TestCells(
+		std::size_t const& rows,
+		std::size_t const& columns,
+		bool const& reorder)
+	{
+		Random random;
+		std::vector<T> cells(rows * columns);
+		for (std::size_t i{ 0 }; i < rows; ++i)
+			for (std::size_t j{ 0 }; j < columns; ++j)
+			{
+				T value = static_cast<T>(random.next());
+				if (reorder)
+				{
+					if (i <= j)
+						value = 0;
+					else if (i == j + 1)
+						value += static_cast<T>(columns);
+				}
+				else if (i == j)
+					value += static_cast<T>(columns);
+				cells[i * columns + j] = value;
+			}
+		if (reorder)
+			cells[columns - 1] = static_cast<T>(columns);
+
+		return cells;
+	};
+
+	template<typename T>
+	std::string_view TypeName()
+	{
+		if constexpr (std::is_same_v<T, float>)
+			return "float";
+		else if constexpr (std::is_same_v<T, double>)
+			return "double";
+		else if constexpr (std::is_same_v<T, long double>)
+			return "long double";
+		else
+			return "float128";
+	};
+
+	class Report final
+	{
+
+	private:
+
+		bool first{ true };
+
+	public:
+
+		Report()
+		{
+			std::cout << "[\n";
+		};
+
+		~Report()
+		{
+			std::cout << "\n]\n";
+		};
+
+		// flops is the number of floating point operations of one call, 0 if none
+		void add(
+			std::string_view const& benchmark,
+			std::string_view const& type,
+			std::size_t const& rows,
+			std::size_t const& columns,
+			std::string_view const& path,
+			double const& nanoseconds,
+			double const& flops)
+		{
+			std::cout << (first ? "" : ",\n") << std::fixed
+				<< "  { \"benchmark\": \"" << benchmark << "\", \"type\": \"" << type
+				<< "\", \"rows\": " << rows << ", \"columns\": " << columns
+				<< ", \"path\": \"" << path << "\", \"ns_per_call\": " << std::setprecision(1) << nanoseconds
+				<< ", \"gflops\": ";
+			if (flops > 0)
+				std::cout << std::setprecision(3) << flops / nanoseconds << " }";
+			else
+				std::cout << "null }";
+			std::cout.flush();
+			first = false;
+		};
+
+	};
+
+	template<typename T>
+	void Run(
+		Report& report,
+		std::size_t const& max_columns)
+	{
+		std::string_view const type = TypeName<T>();
+
+		for (std::size_t columns{ 4 }; columns <= max_columns; columns *= 4)
+			for (std::size_t const rows : { columns, 2 * columns })
+			{
+				std::vector<T> equal(rows);
+				Random random;
+				for (T& value : equal)
+					value = static_cast<T>(random.next());
+
+				// Construction from bulk data
+				std::vector<T> const cells = TestCells<T>(rows, columns, false);
+				report.add("construct", type, rows, columns, "assign", NanosecondsPerCall([&]
+					{
+						GaussJordan::Matrix<T> matrix(rows, columns);
+						matrix.assign(cells);
+						KeepAlive(matrix);
+					}), 0);
+
+				for (bool const reorder : { false, true })
+				{
+					GaussJordan::Matrix<T> matrix(rows, columns);
+					matrix.assign(TestCells<T>(rows, columns, reorder));
+
+					GaussJordan::Workspace<T> workspace;
+					std::vector<T> result;
+					if (!GaussJordan::Solve(matrix, equal, workspace, result))
+						continue;
+
+					// Each eliminated column updates whole rows, of the first n_columns rows
+					double const flops = 2.0 * columns * columns * columns;
+					report.add("solve", type, rows, columns, reorder ? "reorder" : "direct", NanosecondsPerCall([&]
+						{
+							GaussJordan::Solve(matrix, equal, workspace, result);
+							KeepAlive(result);
+						}), flops);
+
+					if (reorder)
+						continue;
+
+					report.add("error_estimate", type, rows, columns, "direct", NanosecondsPerCall([&]
+						{
+							T const error = GaussJordan::ErrorEstimate(matrix, equal, result);
+							KeepAlive(error);
+						}), 2.0 * rows * columns);
+				}
+			}
+	};
+
+	// Many small systems, as in a sweep. A loop of Solve with a reused Workspace
+	// is the baseline for SolveBatch.
+	// Times are per system
+	template<typename T>
+	void RunBatch(
+		Report& report,
+		std::size_t const& n_systems)
+	{
+		std::string_view const type = TypeName<T>();
+
+		for (std::size_t const columns : { 4, 8, 16 })
+		{
+			std::vector<T> const cells = TestCells<T>(columns, columns, false);
+			std::vector<GaussJordan::Matrix<T>> matrices(n_systems, GaussJordan::Matrix<T>(columns, columns));
+			std::vector<std::vector<T>> equals(n_systems, std::vector<T>(columns));
+			Random random;
+			for (std::size_t i{ 0 }; i < n_systems; ++i)
+			{
+				matrices[i].assign(cells);
+				for (T& value : equals[i])
+					value = static_cast<T>(random.next());
+			}
+
+			double const flops = 2.0 * columns * columns * columns;
+			std::vector<std::vector<T>> results;
+
+			GaussJordan::Workspace<T> workspace;
+			results.resize(n_systems);
+			report.add("solve_batch", type, columns, columns, "solve_loop", NanosecondsPerCall([&]
+				{
+					for (std::size_t i{ 0 }; i < n_systems; ++i)
+						GaussJordan::Solve(matrices[i], equals[i], workspace, results[i]);
+					KeepAlive(results);
+				}) / n_systems, flops);
+
+			report.add("solve_batch", type, columns, columns, "cpu", NanosecondsPerCall([&]
+				{
+					GaussJordan::SolveBatch(std::span<GaussJordan::Matrix<T> const>(matrices), std::span<std::vector<T> const>(equals), results);
+					KeepAlive(results);
+				}) / n_systems, flops);
+		}
+	};
+
+};
+
+int main()
+{
+	Report report;
+
+	Run<float>(report, 256);
+	Run<double>(report, 256);
+	Run<long double>(report, 256);
+
+	// Software float128 is much slower, so smaller sizes only
+	if constexpr (!std::is_same_v<Real, long double>)
+		Run<Real>(report, 64);
+
+	RunBatch<float>(report, 1 << 16);
+	RunBatch<double>(report, 1 << 16);
+
+	return 0;
+};
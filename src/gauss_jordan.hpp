@@ -18,14 +18,53 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <format>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory_resource>
+#include <mutex>
 #include <numbers>
+#include <optional>
+#include <set>
+#include <span>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Vectorized row update, define GAUSS_JORDAN_NO_SIMD to use plain loops only
+#if !defined(GAUSS_JORDAN_NO_SIMD)
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define GAUSS_JORDAN_SIMD_X86
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GAUSS_JORDAN_SIMD_NEON
+#endif
+#endif
+
+// Memory mapped files, define GAUSS_JORDAN_NO_MMAP to read files into memory instead
+#if !defined(GAUSS_JORDAN_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GAUSS_JORDAN_MMAP
+#endif
+
 // C++23
 #if __STDCPP_FLOAT128_T__ == 1
 #include <stdfloat>
@@ -34,7 +73,7 @@ using Real = std::float128_t;
 using Real = long double;
 #endif
 
-std::string RealToString(
+inline std::string RealToString(
 	Real const& value,
 	uint8_t const& decimals = 8)
 {
@@ -53,7 +92,7 @@ std::string RealToString(
 
 #if __STDCPP_FLOAT128_T__ == 1
 // Currently no support in C++23 for std::cout of std::float128_t
-std::ostream& operator<<(
+inline std::ostream& operator<<(
 	std::ostream& os,
 	Real const& value)
 {
@@ -64,116 +103,774 @@ std::ostream& operator<<(
 Real constexpr pi = std::numbers::pi_v<Real>;
 
 // Return 'Not a Number', without throwing an exception
+template<typename T>
+T constexpr NaN_v = std::numeric_limits<T>::quiet_NaN();
 Real constexpr NaN = std::numeric_limits<long double>::quiet_NaN();
 
 // Numeric stability
 // Smallest value such that 1+epsilon evaluates to 1
-Real constexpr numeric_epsilon = std::numeric_limits<Real>::epsilon();
+template<typename T>
+T constexpr numeric_epsilon_v = std::numeric_limits<T>::epsilon();
+Real constexpr numeric_epsilon = numeric_epsilon_v<Real>;
 
 // The magnitude below which a number is considered to be zero
-Real constexpr magnitude_zero = std::numeric_limits<float>::epsilon();
+template<typename T>
+T constexpr magnitude_zero_v = std::numeric_limits<float>::epsilon();
+Real constexpr magnitude_zero = magnitude_zero_v<Real>;
 
 namespace GaussJordan
 {
 
-	// Only square or overdetermined matrices are supported
+	namespace Detail
+	{
+
+		// Constant evaluation versions of std::abs and std::isfinite
+		template<typename T>
+		constexpr T Abs(
+			T const& value)
+		{
+			return (value < 0) ? -value : value;
+		};
+
+		template<typename T>
+		constexpr bool IsFinite(
+			T const& value)
+		{
+			return (value - value) == T{ 0 };
+		};
+
+		// True if all values are finite, in a single pass without branches.
+		// value * 0 is zero for finite values and NaN otherwise,
+		// the independent sums let the loop use vector instructions
+		template<typename T>
+		bool AllFinite(
+			std::span<T const> data)
+		{
+			std::size_t constexpr lanes{ 8 };
+			std::array<T, lanes> sum{};
+
+			std::size_t i{ 0 };
+			for (; i + lanes <= data.size(); i += lanes)
+				for (std::size_t k{ 0 }; k < lanes; ++k)
+					sum[k] += data[i + k] * 0;
+			for (; i < data.size(); ++i)
+				sum[0] += data[i] * 0;
+
+			T total{ 0 };
+			for (T const& value : sum)
+				total += value;
+
+			return total == 0;
+		};
+
+		// Kernels for target -= source * scalar, on n cells.
+		// Multiply and subtract are kept separate (no fused multiply add),
+		// so results do not depend on the instruction set in use.
+		// The AVX-512 rounding variants stop the compiler from fusing them
+#if defined(GAUSS_JORDAN_SIMD_X86)
+		__attribute__((target("avx512f")))
+		inline void AxpyAvx512(
+			double* const target,
+			double const* const source,
+			double const scalar,
+			std::size_t const n)
+		{
+			int constexpr rounding{ _MM_FROUND_CUR_DIRECTION };
+			__m512d const factor = _mm512_set1_pd(scalar);
+			for (std::size_t i{ 0 }; i < n; i += 8)
+			{
+				// The tail is masked, instead of a scalar loop the compiler may fuse
+				__mmask8 const mask = (n - i >= 8) ? 0xFF : __mmask8((1u << (n - i)) - 1);
+				__m512d const product = _mm512_maskz_mul_round_pd(mask, _mm512_maskz_loadu_pd(mask, source + i), factor, rounding);
+				_mm512_mask_storeu_pd(target + i, mask,
+					_mm512_maskz_sub_round_pd(mask, _mm512_maskz_loadu_pd(mask, target + i), product, rounding));
+			}
+		};
+
+		__attribute__((target("avx512f")))
+		inline void AxpyAvx512(
+			float* const target,
+			float const* const source,
+			float const scalar,
+			std::size_t const n)
+		{
+			int constexpr rounding{ _MM_FROUND_CUR_DIRECTION };
+			__m512 const factor = _mm512_set1_ps(scalar);
+			for (std::size_t i{ 0 }; i < n; i += 16)
+			{
+				// The tail is masked, instead of a scalar loop the compiler may fuse
+				__mmask16 const mask = (n - i >= 16) ? 0xFFFF : __mmask16((1u << (n - i)) - 1);
+				__m512 const product = _mm512_maskz_mul_round_ps(mask, _mm512_maskz_loadu_ps(mask, source + i), factor, rounding);
+				_mm512_mask_storeu_ps(target + i, mask,
+					_mm512_maskz_sub_round_ps(mask, _mm512_maskz_loadu_ps(mask, target + i), product, rounding));
+			}
+		};
+
+		__attribute__((target("avx2")))
+		inline void AxpyAvx2(
+			double* const target,
+			double const* const source,
+			double const scalar,
+			std::size_t const n)
+		{
+			__m256d const factor = _mm256_set1_pd(scalar);
+			std::size_t i{ 0 };
+			for (; i + 4 <= n; i += 4)
+				_mm256_storeu_pd(target + i, _mm256_sub_pd(_mm256_loadu_pd(target + i),
+					_mm256_mul_pd(_mm256_loadu_pd(source + i), factor)));
+			for (; i < n; ++i)
+				target[i] -= source[i] * scalar;
+		};
+
+		__attribute__((target("avx2")))
+		inline void AxpyAvx2(
+			float* const target,
+			float const* const source,
+			float const scalar,
+			std::size_t const n)
+		{
+			__m256 const factor = _mm256_set1_ps(scalar);
+			std::size_t i{ 0 };
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(target + i, _mm256_sub_ps(_mm256_loadu_ps(target + i),
+					_mm256_mul_ps(_mm256_loadu_ps(source + i), factor)));
+			for (; i < n; ++i)
+				target[i] -= source[i] * scalar;
+		};
+
+		// Kernels of the batched solve, a separate scalar per lane.
+		// AxpyLanes: target[b * n + i] -= source[b * n + i] * scalar[i], for blocks of n lanes.
+		// DivideLanes: quotient[i] = numerator[i] / denominator[i], and check[i] += quotient[i] * 0,
+		// so check stays zero while all quotients are finite
+		__attribute__((target("avx512f")))
+		inline void AxpyLanesAvx512(
+			double* __restrict const target,
+			double const* __restrict const source,
+			double const* __restrict const scalar,
+			std::size_t const n,
+			std::size_t const blocks)
+		{
+			int constexpr rounding{ _MM_FROUND_CUR_DIRECTION };
+			for (std::size_t i{ 0 }; i < n; i += 8)
+			{
+				__mmask8 const mask = (n - i >= 8) ? 0xFF : __mmask8((1u << (n - i)) - 1);
+				__m512d const factor = _mm512_maskz_loadu_pd(mask, scalar + i);
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+				{
+					std::size_t const offset = b * n + i;
+					__m512d const product = _mm512_maskz_mul_round_pd(mask, _mm512_maskz_loadu_pd(mask, source + offset), factor, rounding);
+					_mm512_mask_storeu_pd(target + offset, mask,
+						_mm512_maskz_sub_round_pd(mask, _mm512_maskz_loadu_pd(mask, target + offset), product, rounding));
+				}
+			}
+		};
+
+		__attribute__((target("avx512f")))
+		inline void AxpyLanesAvx512(
+			float* __restrict const target,
+			float const* __restrict const source,
+			float const* __restrict const scalar,
+			std::size_t const n,
+			std::size_t const blocks)
+		{
+			int constexpr rounding{ _MM_FROUND_CUR_DIRECTION };
+			for (std::size_t i{ 0 }; i < n; i += 16)
+			{
+				__mmask16 const mask = (n - i >= 16) ? 0xFFFF : __mmask16((1u << (n - i)) - 1);
+				__m512 const factor = _mm512_maskz_loadu_ps(mask, scalar + i);
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+				{
+					std::size_t const offset = b * n + i;
+					__m512 const product = _mm512_maskz_mul_round_ps(mask, _mm512_maskz_loadu_ps(mask, source + offset), factor, rounding);
+					_mm512_mask_storeu_ps(target + offset, mask,
+						_mm512_maskz_sub_round_ps(mask, _mm512_maskz_loadu_ps(mask, target + offset), product, rounding));
+				}
+			}
+		};
+
+		__attribute__((target("avx512f")))
+		inline void DivideLanesAvx512(
+			double* __restrict const quotient,
+			double const* __restrict const numerator,
+			double const* __restrict const denominator,
+			double* __restrict const check,
+			std::size_t const n)
+		{
+			int constexpr rounding{ _MM_FROUND_CUR_DIRECTION };
+			__m512d const zero = _mm512_setzero_pd();
+			for (std::size_t i{ 0 }; i < n; i += 8)
+			{
+				// Masked out lanes divide 0 / 1
+				__mmask8 const mask = (n - i >= 8) ? 0xFF : __mmask8((1u << (n - i)) - 1);
+				__m512d const value = _mm512_maskz_div_round_pd(mask, _mm512_maskz_loadu_pd(mask, numerator + i),
+					_mm512_mask_loadu_pd(_mm512_set1_pd(1), mask, denominator + i), rounding);
+				_mm512_mask_storeu_pd(quotient + i, mask, value);
+				_mm512_mask_storeu_pd(check + i, mask,
+					_mm512_maskz_add_round_pd(mask, _mm512_maskz_loadu_pd(mask, check + i), _mm512_maskz_mul_round_pd(mask, value, zero, rounding), rounding));
+			}
+		};
+
+		__attribute__((target("avx512f")))
+		inline void DivideLanesAvx512(
+			float* __restrict const quotient,
+			float const* __restrict const numerator,
+			float const* __restrict const denominator,
+			float* __restrict const check,
+			std::size_t const n)
+		{
+			int constexpr rounding{ _MM_FROUND_CUR_DIRECTION };
+			__m512 const zero = _mm512_setzero_ps();
+			for (std::size_t i{ 0 }; i < n; i += 16)
+			{
+				// Masked out lanes divide 0 / 1
+				__mmask16 const mask = (n - i >= 16) ? 0xFFFF : __mmask16((1u << (n - i)) - 1);
+				__m512 const value = _mm512_maskz_div_round_ps(mask, _mm512_maskz_loadu_ps(mask, numerator + i),
+					_mm512_mask_loadu_ps(_mm512_set1_ps(1), mask, denominator + i), rounding);
+				_mm512_mask_storeu_ps(quotient + i, mask, value);
+				_mm512_mask_storeu_ps(check + i, mask,
+					_mm512_maskz_add_round_ps(mask, _mm512_maskz_loadu_ps(mask, check + i), _mm512_maskz_mul_round_ps(mask, value, zero, rounding), rounding));
+			}
+		};
+
+		__attribute__((target("avx2")))
+		inline void AxpyLanesAvx2(
+			double* __restrict const target,
+			double const* __restrict const source,
+			double const* __restrict const scalar,
+			std::size_t const n,
+			std::size_t const blocks)
+		{
+			std::size_t i{ 0 };
+			for (; i + 4 <= n; i += 4)
+			{
+				__m256d const factor = _mm256_loadu_pd(scalar + i);
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					_mm256_storeu_pd(target + b * n + i, _mm256_sub_pd(_mm256_loadu_pd(target + b * n + i),
+						_mm256_mul_pd(_mm256_loadu_pd(source + b * n + i), factor)));
+			}
+			for (; i < n; ++i)
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					target[b * n + i] -= source[b * n + i] * scalar[i];
+		};
+
+		__attribute__((target("avx2")))
+		inline void AxpyLanesAvx2(
+			float* __restrict const target,
+			float const* __restrict const source,
+			float const* __restrict const scalar,
+			std::size_t const n,
+			std::size_t const blocks)
+		{
+			std::size_t i{ 0 };
+			for (; i + 8 <= n; i += 8)
+			{
+				__m256 const factor = _mm256_loadu_ps(scalar + i);
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					_mm256_storeu_ps(target + b * n + i, _mm256_sub_ps(_mm256_loadu_ps(target + b * n + i),
+						_mm256_mul_ps(_mm256_loadu_ps(source + b * n + i), factor)));
+			}
+			for (; i < n; ++i)
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					target[b * n + i] -= source[b * n + i] * scalar[i];
+		};
+
+		__attribute__((target("avx2")))
+		inline void DivideLanesAvx2(
+			double* __restrict const quotient,
+			double const* __restrict const numerator,
+			double const* __restrict const denominator,
+			double* __restrict const check,
+			std::size_t const n)
+		{
+			__m256d const zero = _mm256_setzero_pd();
+			std::size_t i{ 0 };
+			for (; i + 4 <= n; i += 4)
+			{
+				__m256d const value = _mm256_div_pd(_mm256_loadu_pd(numerator + i), _mm256_loadu_pd(denominator + i));
+				_mm256_storeu_pd(quotient + i, value);
+				_mm256_storeu_pd(check + i, _mm256_add_pd(_mm256_loadu_pd(check + i), _mm256_mul_pd(value, zero)));
+			}
+			for (; i < n; ++i)
+			{
+				quotient[i] = numerator[i] / denominator[i];
+				check[i] += quotient[i] * 0;
+			}
+		};
+
+		__attribute__((target("avx2")))
+		inline void DivideLanesAvx2(
+			float* __restrict const quotient,
+			float const* __restrict const numerator,
+			float const* __restrict const denominator,
+			float* __restrict const check,
+			std::size_t const n)
+		{
+			__m256 const zero = _mm256_setzero_ps();
+			std::size_t i{ 0 };
+			for (; i + 8 <= n; i += 8)
+			{
+				__m256 const value = _mm256_div_ps(_mm256_loadu_ps(numerator + i), _mm256_loadu_ps(denominator + i));
+				_mm256_storeu_ps(quotient + i, value);
+				_mm256_storeu_ps(check + i, _mm256_add_ps(_mm256_loadu_ps(check + i), _mm256_mul_ps(value, zero)));
+			}
+			for (; i < n; ++i)
+			{
+				quotient[i] = numerator[i] / denominator[i];
+				check[i] += quotient[i] * 0;
+			}
+		};
+
+		enum class Simd : uint8_t
+		{
+			None,
+			Avx2,
+			Avx512
+		};
+
+		// Instruction set of the running processor, detected once
+		inline Simd DetectSimd()
+		{
+			static Simd const simd = []
+				{
+					__builtin_cpu_init();
+					if (__builtin_cpu_supports("avx512f"))
+						return Simd::Avx512;
+					if (__builtin_cpu_supports("avx2"))
+						return Simd::Avx2;
+					return Simd::None;
+				}();
+			return simd;
+		};
+#elif defined(GAUSS_JORDAN_SIMD_NEON)
+		inline void AxpyNeon(
+			double* const target,
+			double const* const source,
+			double const scalar,
+			std::size_t const n)
+		{
+			float64x2_t const factor = vdupq_n_f64(scalar);
+			std::size_t i{ 0 };
+			for (; i + 2 <= n; i += 2)
+				vst1q_f64(target + i, vsubq_f64(vld1q_f64(target + i), vmulq_f64(vld1q_f64(source + i), factor)));
+			for (; i < n; ++i)
+				target[i] -= source[i] * scalar;
+		};
+
+		inline void AxpyNeon(
+			float* const target,
+			float const* const source,
+			float const scalar,
+			std::size_t const n)
+		{
+			float32x4_t const factor = vdupq_n_f32(scalar);
+			std::size_t i{ 0 };
+			for (; i + 4 <= n; i += 4)
+				vst1q_f32(target + i, vsubq_f32(vld1q_f32(target + i), vmulq_f32(vld1q_f32(source + i), factor)));
+			for (; i < n; ++i)
+				target[i] -= source[i] * scalar;
+		};
+
+		// Kernels of the batched solve, a separate scalar per lane.
+		// AxpyLanes: target[b * n + i] -= source[b * n + i] * scalar[i], for blocks of n lanes.
+		// DivideLanes: quotient[i] = numerator[i] / denominator[i], and check[i] += quotient[i] * 0,
+		// so check stays zero while all quotients are finite
+		inline void AxpyLanesNeon(
+			double* __restrict const target,
+			double const* __restrict const source,
+			double const* __restrict const scalar,
+			std::size_t const n,
+			std::size_t const blocks)
+		{
+			std::size_t i{ 0 };
+			for (; i + 2 <= n; i += 2)
+			{
+				float64x2_t const factor = vld1q_f64(scalar + i);
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					vst1q_f64(target + b * n + i, vsubq_f64(vld1q_f64(target + b * n + i), vmulq_f64(vld1q_f64(source + b * n + i), factor)));
+			}
+			for (; i < n; ++i)
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					target[b * n + i] -= source[b * n + i] * scalar[i];
+		};
+
+		inline void AxpyLanesNeon(
+			float* __restrict const target,
+			float const* __restrict const source,
+			float const* __restrict const scalar,
+			std::size_t const n,
+			std::size_t const blocks)
+		{
+			std::size_t i{ 0 };
+			for (; i + 4 <= n; i += 4)
+			{
+				float32x4_t const factor = vld1q_f32(scalar + i);
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					vst1q_f32(target + b * n + i, vsubq_f32(vld1q_f32(target + b * n + i), vmulq_f32(vld1q_f32(source + b * n + i), factor)));
+			}
+			for (; i < n; ++i)
+				for (std::size_t b{ 0 }; b < blocks; ++b)
+					target[b * n + i] -= source[b * n + i] * scalar[i];
+		};
+
+		inline void DivideLanesNeon(
+			double* __restrict const quotient,
+			double const* __restrict const numerator,
+			double const* __restrict const denominator,
+			double* __restrict const check,
+			std::size_t const n)
+		{
+			float64x2_t const zero = vdupq_n_f64(0);
+			std::size_t i{ 0 };
+			for (; i + 2 <= n; i += 2)
+			{
+				float64x2_t const value = vdivq_f64(vld1q_f64(numerator + i), vld1q_f64(denominator + i));
+				vst1q_f64(quotient + i, value);
+				vst1q_f64(check + i, vaddq_f64(vld1q_f64(check + i), vmulq_f64(value, zero)));
+			}
+			for (; i < n; ++i)
+			{
+				quotient[i] = numerator[i] / denominator[i];
+				check[i] += quotient[i] * 0;
+			}
+		};
+
+		inline void DivideLanesNeon(
+			float* __restrict const quotient,
+			float const* __restrict const numerator,
+			float const* __restrict const denominator,
+			float* __restrict const check,
+			std::size_t const n)
+		{
+			float32x4_t const zero = vdupq_n_f32(0);
+			std::size_t i{ 0 };
+			for (; i + 4 <= n; i += 4)
+			{
+				float32x4_t const value = vdivq_f32(vld1q_f32(numerator + i), vld1q_f32(denominator + i));
+				vst1q_f32(quotient + i, value);
+				vst1q_f32(check + i, vaddq_f32(vld1q_f32(check + i), vmulq_f32(value, zero)));
+			}
+			for (; i < n; ++i)
+			{
+				quotient[i] = numerator[i] / denominator[i];
+				check[i] += quotient[i] * 0;
+			}
+		};
+#endif
+
+		// Row update target -= source * scalar, the hot loop of elimination.
+		// float and double use the widest vector instructions available,
+		// other types a plain loop
+		template<typename T>
+		void Axpy(
+			std::span<T> target,
+			std::span<T const> source,
+			T const& scalar)
+		{
+			std::size_t const n = target.size();
+			T* const y = target.data();
+			T const* const x = source.data();
+
+#if defined(GAUSS_JORDAN_SIMD_X86)
+			if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+				switch (DetectSimd())
+				{
+				case Simd::Avx512:
+					return AxpyAvx512(y, x, scalar, n);
+				case Simd::Avx2:
+					return AxpyAvx2(y, x, scalar, n);
+				default:
+					break;
+				}
+#elif defined(GAUSS_JORDAN_SIMD_NEON)
+			if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+				return AxpyNeon(y, x, scalar, n);
+#endif
+
+			for (std::size_t i{ 0 }; i < n; ++i)
+				y[i] -= x[i] * scalar;
+		};
+
+		// Batched row update target -= source * scalar, with a scalar per lane,
+		// for blocks consecutive groups of n lanes
+		template<typename T>
+		void AxpyLanes(
+			T* __restrict const target,
+			T const* __restrict const source,
+			T const* __restrict const scalar,
+			std::size_t const& n,
+			std::size_t const& blocks = 1)
+		{
+#if defined(GAUSS_JORDAN_SIMD_X86)
+			if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+				switch (DetectSimd())
+				{
+				case Simd::Avx512:
+					return AxpyLanesAvx512(target, source, scalar, n, blocks);
+				case Simd::Avx2:
+					return AxpyLanesAvx2(target, source, scalar, n, blocks);
+				default:
+					break;
+				}
+#elif defined(GAUSS_JORDAN_SIMD_NEON)
+			if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+				return AxpyLanesNeon(target, source, scalar, n, blocks);
+#endif
+
+			for (std::size_t b{ 0 }; b < blocks; ++b)
+				for (std::size_t i{ 0 }; i < n; ++i)
+					target[b * n + i] -= source[b * n + i] * scalar[i];
+		};
+
+		// Batched quotient = numerator / denominator, check += quotient * 0 per lane
+		template<typename T>
+		void DivideLanes(
+			T* __restrict const quotient,
+			T const* __restrict const numerator,
+			T const* __restrict const denominator,
+			T* __restrict const check,
+			std::size_t const& n)
+		{
+#if defined(GAUSS_JORDAN_SIMD_X86)
+			if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+				switch (DetectSimd())
+				{
+				case Simd::Avx512:
+					return DivideLanesAvx512(quotient, numerator, denominator, check, n);
+				case Simd::Avx2:
+					return DivideLanesAvx2(quotient, numerator, denominator, check, n);
+				default:
+					break;
+				}
+#elif defined(GAUSS_JORDAN_SIMD_NEON)
+			if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+				return DivideLanesNeon(quotient, numerator, denominator, check, n);
+#endif
+
+			for (std::size_t i{ 0 }; i < n; ++i)
+			{
+				quotient[i] = numerator[i] / denominator[i];
+				check[i] += quotient[i] * 0;
+			}
+		};
+
+	};
+
+	// Only square or overdetermined matrices can be solved,
+	// other shapes are used for multiple right hand sides and results
+	template<typename T = Real>
 	class Matrix final
 	{
 
 	private:
 
-		uint8_t n_rows{ 0 };
-		uint8_t n_columns{ 0 };
+		// Rows are padded to a whole number of cache lines
+		static std::size_t constexpr row_alignment{ std::max<std::size_t>(1, 64 / sizeof(T)) };
+
+		std::size_t n_rows{ 0 };
+		std::size_t n_columns{ 0 };
 
-		std::vector<std::vector<Real>> cell{ 0 };
+		// Distance between the first cells of two consecutive rows
+		std::size_t stride{ 0 };
+
+		// Row-major storage in one contiguous block
+		std::pmr::vector<T> cell{};
 
 		// Used if out of range row/column is used
 		// for read/write to matrix cell
-		Real dummy{ NaN };
+		T dummy{ NaN_v<T> };
 
 	public:
 
 		Matrix() {};
 
+		// Empty matrix, memory is allocated from resource
+		explicit Matrix(
+			std::pmr::memory_resource* resource)
+			: cell(resource)
+		{};
+
 		Matrix(
-			uint8_t const& rows,
-			uint8_t const& columns)
+			std::size_t const& rows,
+			std::size_t const& columns,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: cell(resource)
 		{
-			if (rows < columns)
-				return;
-
-			n_rows = rows;
-			n_columns = columns;
+			resize(rows, columns);
+		};
 
-			cell = std::vector<std::vector<Real>>(rows, std::vector<Real>(columns, 0));
+		// Copy of a matrix with another scalar type
+		template<typename U>
+		explicit Matrix(
+			Matrix<U> const& other)
+			: Matrix(std::get<0>(other.size()), std::get<1>(other.size()))
+		{
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+			{
+				std::span<U const> const source = other.row(i);
+				std::transform(source.begin(), source.end(), row(i).begin(),
+					[](U const& value) { return static_cast<T>(value); });
+			}
 		};
 
 		// Read/Write the value at [row,column]
-		Real& operator () (
-			uint8_t const& row,
-			uint8_t const& column)
+		T& operator () (
+			std::size_t const& row,
+			std::size_t const& column)
 		{
 			if ((row >= n_rows) || (column >= n_columns))
 				return dummy;
 
-			return cell[row][column];
+			return cell[row * stride + column];
 		};
 
 		// Get the value at [row,column]
-		Real operator () (
-			uint8_t const& row,
-			uint8_t const& column) const
+		T operator () (
+			std::size_t const& row,
+			std::size_t const& column) const
 		{
 			if ((row >= n_rows) || (column >= n_columns))
-				return NaN;
+				return NaN_v<T>;
 
-			return cell[row][column];
+			return cell[row * stride + column];
+		};
+
+		// Read/Write the value at [row,column], without range check.
+		// For trusted callers and the solver kernels
+		T& at_unchecked(
+			std::size_t const& row,
+			std::size_t const& column)
+		{
+			return cell[row * stride + column];
+		};
+
+		// Get the value at [row,column], without range check
+		T const& at_unchecked(
+			std::size_t const& row,
+			std::size_t const& column) const
+		{
+			return cell[row * stride + column];
+		};
+
+		// First cell of a row, without range check.
+		// Rows are row_stride() cells apart in memory
+		T* row_data(
+			std::size_t const& index)
+		{
+			return cell.data() + index * stride;
+		};
+
+		T const* row_data(
+			std::size_t const& index) const
+		{
+			return cell.data() + index * stride;
+		};
+
+		// Distance between the first cells of two consecutive rows
+		std::size_t row_stride() const
+		{
+			return stride;
+		};
+
+		// Read/Write access to the cells of a row,
+		// empty if the row is out of range
+		std::span<T> row(
+			std::size_t const& index)
+		{
+			if (index >= n_rows)
+				return {};
+
+			return std::span<T>(cell.data() + index * stride, n_columns);
+		};
+
+		// Read access to the cells of a row,
+		// empty if the row is out of range
+		std::span<T const> row(
+			std::size_t const& index) const
+		{
+			if (index >= n_rows)
+				return {};
+
+			return std::span<T const>(cell.data() + index * stride, n_columns);
 		};
 
 		void set_row(
-			uint8_t const& index,
-			std::vector<Real> const& data)
+			std::size_t const& index,
+			std::vector<T> const& data)
 		{
-			if ((!n_columns) || (data.size() != n_columns))
+			if ((index >= n_rows) || (data.size() != n_columns) || !Detail::AllFinite(std::span<T const>(data)))
 				return;
 
-			for (uint16_t i{ 0 };i < n_columns;++i)
-				if (!std::isfinite(data[i]))
-					return;
-
-			cell[index] = data;
+			std::copy(data.begin(), data.end(), row(index).begin());
 		};
 
 		void set_column(
-			uint8_t const& index,
-			std::vector<Real> const& data)
+			std::size_t const& index,
+			std::vector<T> const& data)
 		{
-			if ((!n_rows) || (data.size() != n_rows))
+			if ((index >= n_columns) || (data.size() != n_rows) || !Detail::AllFinite(std::span<T const>(data)))
 				return;
 
-			for (uint16_t i{ 0 };i < n_rows;++i)
-				if (!std::isfinite(data[i]))
-					return;
+			for (std::size_t i{ 0 };i < n_rows;++i)
+				cell[i * stride + index] = data[i];
+		};
+
+		// Change the size, with all cells zero.
+		// Memory is only allocated if the new size does not fit the capacity
+		void resize(
+			std::size_t const& rows,
+			std::size_t const& columns)
+		{
+			n_rows = rows;
+			n_columns = columns;
+			stride = ((columns + row_alignment - 1) / row_alignment) * row_alignment;
+
+			cell.assign(rows * stride, 0);
+		};
+
+		// Set all cells to zero, keeping the size
+		void reset()
+		{
+			std::fill(cell.begin(), cell.end(), T{ 0 });
+		};
+
+		// Memory resource the cells are allocated from
+		std::pmr::memory_resource* resource() const
+		{
+			return cell.get_allocator().resource();
+		};
+
+		// Set all cells from row-major data, with n_rows * n_columns values.
+		// The matrix is unchanged if the size is wrong or a value is not finite
+		bool assign(
+			std::span<T const> data)
+		{
+			if ((data.size() != n_rows * n_columns) || !Detail::AllFinite(data))
+				return false;
 
-			for (uint16_t i{ 0 };i < n_rows;++i)
-				cell[i][index] = data[i];
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+			{
+				std::span<T const> const source = data.subspan(i * n_columns, n_columns);
+				std::copy(source.begin(), source.end(), row(i).begin());
+			}
+
+			return true;
 		};
 
 		// Returns number of rows and columns
-		std::tuple< uint8_t, uint8_t> size() const
+		std::tuple<std::size_t, std::size_t> size() const
 		{
 			return std::tuple(n_rows, n_columns);
 		};
 
 		// Tests diagonal for zeroes
 		bool is_diagonal_nonzero(
-			Real const& epsilon = magnitude_zero) const
+			T const& epsilon = magnitude_zero_v<T>) const
 		{
 			if (!is_valid())
 				return false;
 
-			for (uint16_t i{ 0 }; i < n_columns; ++i)
-				if (std::abs(cell[i][i]) < epsilon)
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+				if (std::abs(cell[i * stride + i]) < epsilon)
 					return false;
 
 			return true;
@@ -191,152 +888,3912 @@ namespace GaussJordan
 
 		void print() const
 		{
-			std::cout << n_rows + 0 << "x" << n_columns + 0 << " matrix\n";
-			for (uint16_t i = 0;i < n_rows;++i)
+			std::cout << n_rows << "x" << n_columns << " matrix\n";
+			for (std::size_t i = 0;i < n_rows;++i)
 			{
-				for (uint16_t j = 0;j < n_columns;++j)
-					std::cout << cell[i][j] << " ";
+				for (T const& value : row(i))
+					std::cout << value << " ";
 				std::cout << "\n";
 			}
 		};
 
 	};
 
-	// Gauss Jordan elimination
-	std::vector<Real> Solve(
-		Matrix matrix,
-		std::vector<Real> equal,
-		Real const& epsilon = magnitude_zero)
+	// Fixed set of worker threads, used to split loops across cores.
+	// Only one parallel_for may run at a time
+	class ThreadPool final
 	{
-		if (!matrix.is_valid())
-			return {};
 
-		auto const [n_rows, n_columns] = matrix.size();
+	private:
 
-		if (n_rows != equal.size())
-			return {};
+		std::vector<std::thread> workers{};
 
-		// Method uses the diagonal, so it must be non-zero
-		if (!matrix.is_diagonal_nonzero(epsilon))
+		std::mutex mutex{};
+		std::condition_variable start{};
+		std::condition_variable done{};
+
+		// Share of the current parallel_for of each thread,
+		// other threads take from the end once their own is done
+		struct alignas(64) Range
 		{
-			// TODO Mathness: craptastic code I threw together
+			std::mutex mutex{};
+			std::size_t begin{ 0 };
+			std::size_t end{ 0 };
+		};
+		std::vector<Range> ranges{};
 
-			// The non-zero entries for each column
-			std::vector<std::vector<int16_t>> nze_list(n_columns);
-			for (uint16_t column{ 0 };column < n_columns;++column)
-			{
-				for (uint16_t row{ 0 };row < n_rows;++row)
-					if (std::abs(matrix(row, column)) >= epsilon)
-						nze_list[column].push_back(row);
-				// Column has only zeroes
-				if (!nze_list[column].size())
-					return {};
-			}
+		// Current job, called once on each worker
+		void (*job)(void*, std::size_t) { nullptr };
+		void* context{ nullptr };
+		uint64_t generation{ 0 };
+		std::size_t n_running{ 0 };
+		bool stop{ false };
 
-			// Set current used index in row_list
-			std::vector<uint16_t> list_index(n_columns, 0);
-			// Sort matrix so that the major diagonal is non-zero
+		void run(
+			std::size_t const index)
+		{
+			uint64_t seen{ 0 };
+			std::unique_lock lock(mutex);
 			while (1)
 			{
-				std::vector<bool> row_used(n_rows, false);
-
-				// Set row_used state
-				for (uint16_t i{ 0 }; i < n_rows; ++i)
-					row_used[list_index[i]] = true;
-
-				uint16_t n_used{ 0 };
-				for (uint16_t i{ 0 }; i < n_rows; ++i)
-					if (row_used[i])
-						++n_used;
+				start.wait(lock, [&] { return stop || (generation != seen); });
+				if (stop)
+					return;
 
-				if (n_used == n_columns)
-					break;
-				else
-				{
-					// No valid major diagonal found, increment test_indices
-					++list_index[0];
-					for (uint16_t i{ 0 }; i < n_columns - 1; ++i)
-						if (list_index[i] >= nze_list[i].size())
-						{
-							list_index[i] = 0;
-							++list_index[i + 1];
-						}
+				seen = generation;
+				auto const current_job = job;
+				void* const current_context = context;
 
-					// No combination gives a non-zero diagonal
-					if (list_index[n_columns - 1] >= nze_list[n_columns - 1].size())
-						return {};
-				}
-			};
+				lock.unlock();
+				current_job(current_context, index);
+				lock.lock();
 
-			// Construct new (square) matrix and matching equal
-			Matrix new_matrix{ n_columns, n_columns };
-			std::vector<Real> new_equal(n_columns);
-			for (uint16_t row{ 0 }; row < n_columns; ++row)
-			{
-				uint8_t const index = list_index[row];
-				new_equal[row] = equal[index];
-				for (uint16_t column{ 0 }; column < n_columns; ++column)
-					new_matrix(row, column) = matrix(index, column);
+				if (!--n_running)
+					done.notify_one();
 			}
-			std::swap(matrix, new_matrix);
-			std::swap(equal, new_equal);
-		}
+		};
 
-		// Solve as a square matrix
-		// Gauss Jordan elimination
-		for (uint16_t column{ 0 }; column < n_columns; ++column)
-			for (uint16_t row{ 0 }; row < n_columns; ++row)
-				if (row != column)
-				{
-					Real const scalar = matrix(row, column) / matrix(column, column);
-					if (!std::isfinite(scalar))
-						return {};
+	public:
 
-					for (uint16_t k{ 0 }; k < n_columns; ++k)
-						matrix(row, k) -= matrix(column, k) * scalar;
+		// The calling thread takes part in the work,
+		// so n_threads - 1 worker threads are started
+		explicit ThreadPool(
+			std::size_t const& n_threads = std::thread::hardware_concurrency())
+			: ranges(std::max<std::size_t>(n_threads, 1))
+		{
+			for (std::size_t i{ 1 }; i < n_threads; ++i)
+				workers.emplace_back(&ThreadPool::run, this, i);
+		};
 
-					equal[row] -= equal[column] * scalar;
-				}
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator = (ThreadPool const&) = delete;
 
-		// Rescale diagonal to 1, to get result
-		std::vector<Real> result(n_columns);
-		for (uint16_t i{ 0 }; i < n_columns; ++i)
+		~ThreadPool()
 		{
-			Real value = equal[i] / matrix(i, i);
-			if (!std::isfinite(value))
-				return {};
+			{
+				std::lock_guard lock(mutex);
+				stop = true;
+			}
+			start.notify_all();
+			for (std::thread& worker : workers)
+				worker.join();
+		};
 
-			result[i] = value;
-		}
+		// Number of threads, including the caller
+		std::size_t size() const
+		{
+			return workers.size() + 1;
+		};
+
+		// Calls function(begin, end, thread) for chunks of [0, count),
+		// thread is 0 for the calling thread. Returns when all chunks are done.
+		// Each thread works through its own contiguous share, and then steals
+		// half of what is left of the largest remaining share of another thread
+		template<typename Function>
+		void parallel_for(
+			std::size_t const& count,
+			Function&& function,
+			std::size_t chunk = 0)
+		{
+			if (!count)
+				return;
+
+			if (!chunk)
+				chunk = std::max<std::size_t>(1, count / (4 * size()));
+
+			if (workers.empty() || (count <= chunk))
+			{
+				function(std::size_t{ 0 }, count, std::size_t{ 0 });
+				return;
+			}
+
+			std::size_t const n_threads = size();
+			for (std::size_t i{ 0 }; i < n_threads; ++i)
+			{
+				ranges[i].begin = count * i / n_threads;
+				ranges[i].end = count * (i + 1) / n_threads;
+			}
+
+			struct Context
+			{
+				Function& function;
+				std::size_t chunk;
+				std::vector<Range>& ranges;
+			} shared{ function, chunk, ranges };
+
+			auto const work = [](void* data, std::size_t thread)
+				{
+					Context& shared = *static_cast<Context*>(data);
+					Range& own = shared.ranges[thread];
+					while (1)
+					{
+						std::size_t begin;
+						std::size_t end;
+						{
+							std::lock_guard lock(own.mutex);
+							begin = own.begin;
+							end = std::min(begin + shared.chunk, own.end);
+							own.begin = end;
+						}
+
+						if (begin < end)
+						{
+							shared.function(begin, end, thread);
+							continue;
+						}
+
+						// Steal from the thread with the most work left
+						std::size_t victim{ thread };
+						std::size_t most{ 0 };
+						for (std::size_t i{ 0 }; i < shared.ranges.size(); ++i)
+						{
+							Range& other = shared.ranges[i];
+							std::lock_guard lock(other.mutex);
+							if (other.end - other.begin > most)
+							{
+								most = other.end - other.begin;
+								victim = i;
+							}
+						}
+						if (!most)
+							return;
+
+						Range& other = shared.ranges[victim];
+						std::scoped_lock lock(own.mutex, other.mutex);
+						std::size_t const left = other.end - other.begin;
+						if (!left)
+							continue;
+
+						own.begin = other.end - (left + 1) / 2;
+						own.end = other.end;
+						other.end = own.begin;
+					}
+				};
+
+			{
+				std::lock_guard lock(mutex);
+				job = work;
+				context = &shared;
+				n_running = workers.size();
+				++generation;
+			}
+			start.notify_all();
+
+			work(&shared, 0);
+
+			std::unique_lock lock(mutex);
+			done.wait(lock, [&] { return !n_running; });
+		};
+
+	};
+
+	// How the pivot (diagonal) element of each column is chosen
+	enum class Pivot : uint8_t
+	{
+		// Use the rows in the given order,
+		// search for a non-zero diagonal only if needed
+		Diagonal,
+		// Largest magnitude in the column, from rows not yet used
+		Partial,
+		// Largest magnitude in the remaining sub matrix, this also reorders the columns
+		Full
+	};
+
+	// Why Solve stopped without a result
+	enum class Failure : uint8_t
+	{
+		None,
+		// Matrix is not square or overdetermined, or equal has the wrong size
+		InvalidInput,
+		// A column has only zeroes
+		ZeroColumn,
+		// No row order gives a non-zero diagonal
+		NoDiagonal,
+		// No pivot of large enough magnitude, with partial or full pivoting
+		SingularPivot,
+		// A row scalar is not finite
+		NonFiniteScalar,
+		// A result value is not finite
+		NonFiniteResult
+	};
+
+	// Instrumentation of one Solve, filled in if Workspace::stats is set.
+	// Without it, the only cost is a null test per phase
+	template<typename T = Real>
+	struct Stats final
+	{
+		// True if the rows were reordered for a non-zero diagonal
+		bool reordered{ false };
+
+		// True if the reorder used the row order of a PivotCache
+		bool cached{ false };
+
+		// Augmenting paths searched by the search for a non-zero diagonal
+		std::size_t searches{ 0 };
+
+		// Largest magnitude in a pivot row when it is used,
+		// relative to the largest magnitude of the input
+		T pivot_growth{ 0 };
+
+		// Time spent on each phase
+		std::chrono::nanoseconds reorder_time{ 0 };
+		std::chrono::nanoseconds eliminate_time{ 0 };
+
+		Failure failure{ Failure::None };
+	};
+
+	// Row order of the last reordered solve, shared between consecutive solves
+	// of similar matrices (such as the steps of a sweep).
+	// It is tried first, and if any diagonal value it gives is below epsilon
+	// the search for a non-zero diagonal is done as usual.
+	// The result may depend on the cached order (for overdetermined matrices,
+	// or several valid orders), so it depends on which solves came before.
+	// Solve retries with a search if elimination fails, SolveInPlace does not
+	struct PivotCache final
+	{
+		std::vector<std::size_t> origin{};
+
+		// Solves that used the cached order, and those that had to search
+		std::size_t hits{ 0 };
+		std::size_t misses{ 0 };
+
+		void clear()
+		{
+			origin.clear();
+			hits = misses = 0;
+		};
+	};
+
+	// Scratch memory for the solver.
+	// Reusing one between calls of the same size avoids heap allocation,
+	// all of it can come from a caller provided memory resource (such as an arena)
+	template<typename T = Real>
+	struct Workspace final
+	{
+		Workspace() {};
+
+		// All scratch memory is allocated from resource
+		explicit Workspace(
+			std::pmr::memory_resource* resource)
+			: matrix(resource), equal(resource),
+			nze_list(resource), nze_count(resource), list_index(resource), row_used(resource),
+			diagonal(resource), row_column(resource), path(resource), visit(resource), origin(resource),
+			scalar(resource), column_order(resource), scratch(resource)
+		{};
+
+		// Copies of the input, used by Solve
+		Matrix<T> matrix{};
+		std::pmr::vector<T> equal{};
+
+		// Used by the search for a non-zero diagonal
+		std::pmr::vector<std::size_t> nze_list{};
+		std::pmr::vector<std::size_t> nze_count{};
+		std::pmr::vector<std::size_t> list_index{};
+		std::pmr::vector<bool> row_used{};
+		std::pmr::vector<std::size_t> diagonal{};
+		std::pmr::vector<std::size_t> row_column{};
+		std::pmr::vector<std::size_t> path{};
+		std::pmr::vector<std::size_t> visit{};
+
+		// Row order of the last solve, origin[i] is the input row used as pivot row i.
+		// Rows are never moved, reordering only changes this permutation
+		std::pmr::vector<std::size_t> origin{};
+
+		// Row scalars of the current column
+		std::pmr::vector<T> scalar{};
+
+		// Used by full pivoting
+		std::pmr::vector<std::size_t> column_order{};
+		std::pmr::vector<T> scratch{};
+
+		// Optional, splits the row updates of matrices with
+		// at least parallel_threshold columns across the threads
+		ThreadPool* pool{ nullptr };
+		std::size_t parallel_threshold{ 128 };
+
+		// Optional, filled in by each Solve
+		Stats<T>* stats{ nullptr };
+
+		// Optional, row order to try before searching for a non-zero diagonal
+		PivotCache* cache{ nullptr };
+	};
+
+	namespace Detail
+	{
+
+		// Records why the solve failed, returns false
+		template<typename T>
+		bool Fail(
+			Workspace<T>& workspace,
+			Failure const& failure)
+		{
+			if (workspace.stats)
+				workspace.stats->failure = failure;
+
+			return false;
+		};
+
+		// Swaps the content of row a and b, equal may be empty
+		template<typename T>
+		void SwapRows(
+			Matrix<T>& matrix,
+			std::span<T> equal,
+			std::size_t const& a,
+			std::size_t const& b)
+		{
+			if (a == b)
+				return;
+
+			std::span<T> const row_a = matrix.row(a);
+			std::swap_ranges(row_a.begin(), row_a.end(), matrix.row(b).begin());
+			if (!equal.empty())
+				std::swap(equal[a], equal[b]);
+		};
+
+		// Chooses the row of each column for a non-zero major diagonal, as a matching
+		// of columns to rows. Column c may use the nze_count[c] rows from nze_list[c * n_rows].
+		// Of all matchings it finds the one the earlier combinatorial search tried first:
+		// the earliest possible row for the last column, then for the column before, and so on.
+		// Each choice is tested with an augmenting path, so the cost is polynomial.
+		// Afterwards diagonal[c] is the row of column c, and row_column[r] the column of row r
+		// (n_columns if none). position and path (n_columns) and visit (n_rows) are scratch,
+		// searches counts the augmenting paths searched. False if there is no matching
+		constexpr bool MatchDiagonal(
+			std::span<std::size_t const> nze_list,
+			std::span<std::size_t const> nze_count,
+			std::size_t const& n_rows,
+			std::span<std::size_t> diagonal,
+			std::span<std::size_t> row_column,
+			std::span<std::size_t> position,
+			std::span<std::size_t> path,
+			std::span<std::size_t> visit,
+			std::size_t& searches)
+		{
+			std::size_t const n_columns = nze_count.size();
+			std::fill(row_column.begin(), row_column.end(), n_columns);
+			std::fill(visit.begin(), visit.end(), std::size_t{ 0 });
+			std::size_t stamp{ 0 };
+
+			// Depth first search for a path from column start to a row without a column,
+			// through columns below limit only. On success each column on the path takes
+			// the row it reached, so start gets a row and the other columns keep one
+			auto const augment = [&](std::size_t const start, std::size_t const limit)
+				{
+					++searches;
+					++stamp;
+					std::size_t depth{ 0 };
+					path[depth++] = start;
+					position[start] = 0;
+					while (depth)
+					{
+						std::size_t const column = path[depth - 1];
+						if (position[column] == nze_count[column])
+						{
+							--depth;
+							continue;
+						}
+
+						std::size_t const row = nze_list[column * n_rows + position[column]++];
+						if (visit[row] == stamp)
+							continue;
+						visit[row] = stamp;
+
+						std::size_t const next = row_column[row];
+						if (next == n_columns)
+						{
+							for (std::size_t i{ 0 }; i < depth; ++i)
+							{
+								std::size_t const on_path = path[i];
+								diagonal[on_path] = nze_list[on_path * n_rows + position[on_path] - 1];
+								row_column[diagonal[on_path]] = on_path;
+							}
+							return true;
+						}
+
+						// Each column is reached through its own row, so at most once
+						if (next < limit)
+						{
+							position[next] = 0;
+							path[depth++] = next;
+						}
+					}
+
+					return false;
+				};
+
+			// Any complete matching
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+				if (!augment(column, n_columns))
+					return false;
+
+			// From the last column, the earliest row that still leaves a complete
+			// matching for the columns before it, the rows of later columns are fixed
+			for (std::size_t column{ n_columns }; column-- > 0;)
+				for (std::size_t k{ 0 }; k < nze_count[column]; ++k)
+				{
+					std::size_t const row = nze_list[column * n_rows + k];
+					std::size_t const previous = diagonal[column];
+					if (row == previous)
+						break;
+
+					std::size_t const other = row_column[row];
+					if ((other != n_columns) && (other > column))
+						continue;
+
+					diagonal[column] = row;
+					row_column[row] = column;
+					row_column[previous] = n_columns;
+					if ((other == n_columns) || augment(other, column))
+						break;
+
+					diagonal[column] = previous;
+					row_column[previous] = column;
+					row_column[row] = other;
+				}
+
+			return true;
+		};
+
+		// Searches for rows that give a non-zero major diagonal,
+		// the row for each column is stored in workspace.diagonal
+		template<typename T>
+		bool SearchDiagonal(
+			Matrix<T> const& matrix,
+			Workspace<T>& workspace,
+			T const& epsilon)
+		{
+			auto const [n_rows, n_columns] = matrix.size();
+
+			// The non-zero entries for each column,
+			// nze_count[column] rows are stored from nze_list[column * n_rows]
+			std::pmr::vector<std::size_t>& nze_list = workspace.nze_list;
+			std::pmr::vector<std::size_t>& nze_count = workspace.nze_count;
+			nze_list.resize(n_rows * n_columns);
+			nze_count.assign(n_columns, 0);
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+			{
+				for (std::size_t row{ 0 }; row < n_rows; ++row)
+					if (std::abs(matrix.at_unchecked(row, column)) >= epsilon)
+						nze_list[column * n_rows + nze_count[column]++] = row;
+				// Column has only zeroes
+				if (!nze_count[column])
+					return Fail(workspace, Failure::ZeroColumn);
+			}
+
+			std::pmr::vector<std::size_t>& diagonal = workspace.diagonal;
+			diagonal.resize(n_columns);
+			workspace.row_column.resize(n_rows);
+			workspace.list_index.resize(n_columns);
+			workspace.path.resize(n_columns);
+			workspace.visit.resize(n_rows);
+
+			std::size_t searches{ 0 };
+			bool const found = MatchDiagonal(nze_list, nze_count, n_rows,
+				diagonal, workspace.row_column, workspace.list_index, workspace.path, workspace.visit, searches);
+			if (workspace.stats)
+				workspace.stats->searches = searches;
+			if (!found)
+				return Fail(workspace, Failure::NoDiagonal);
+
+			std::pmr::vector<bool>& row_used = workspace.row_used;
+			row_used.assign(n_rows, false);
+			for (std::size_t const row : diagonal)
+				row_used[row] = true;
+
+			return true;
+		};
+
+		// Finds a row order with a non-zero major diagonal, without moving any rows.
+		// Afterwards workspace.origin holds the matrix row of each row in that order,
+		// the chosen rows first and then the remaining rows in their original order
+		template<typename T>
+		bool ReorderDiagonal(
+			Matrix<T> const& matrix,
+			Workspace<T>& workspace,
+			T const& epsilon)
+		{
+			if (!SearchDiagonal(matrix, workspace, epsilon))
+				return false;
+
+			auto const [n_rows, n_columns] = matrix.size();
+
+			// row_used still marks the chosen rows of the search
+			std::pmr::vector<std::size_t>& origin = workspace.origin;
+			origin.assign(workspace.diagonal.begin(), workspace.diagonal.end());
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+				if (!workspace.row_used[i])
+					origin.push_back(i);
+
+			return true;
+		};
+
+		// True if the cached row order gives a non-zero major diagonal,
+		// it is then copied to workspace.origin
+		template<typename T>
+		bool UseCache(
+			Matrix<T> const& matrix,
+			Workspace<T>& workspace,
+			T const& epsilon)
+		{
+			PivotCache* const cache = workspace.cache;
+			auto const [n_rows, n_columns] = matrix.size();
+			if (!cache || (cache->origin.size() != n_rows))
+				return false;
+
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+				if (std::abs(matrix.at_unchecked(cache->origin[i], i)) < epsilon)
+				{
+					++cache->misses;
+					return false;
+				}
+
+			++cache->hits;
+			workspace.origin.assign(cache->origin.begin(), cache->origin.end());
+
+			return true;
+		};
+
+		// Puts equal in the row order of workspace.origin
+		template<typename T>
+		void PermuteEqual(
+			std::span<T> equal,
+			Workspace<T>& workspace)
+		{
+			std::pmr::vector<T>& scratch = workspace.scratch;
+			scratch.assign(equal.begin(), equal.end());
+			for (std::size_t i{ 0 }; i < equal.size(); ++i)
+				equal[i] = scratch[workspace.origin[i]];
+		};
+
+		// Gauss Jordan elimination of the leading square part of the matrix,
+		// the result is written to the first n_columns entries of equal.
+		// Rows of the matrix are used in the order of workspace.origin,
+		// equal must already be in that order.
+		// With partial or full pivoting all rows are pivot candidates,
+		// and the order is changed as elimination progresses.
+		// The last n_right columns of the matrix are further right hand sides,
+		// updated with the rest of each row, equal may then be empty.
+		// Their results are in row origin[i] for column column_order[i] (or i)
+		template<typename T>
+		bool Eliminate(
+			Matrix<T>& matrix,
+			std::span<T> equal,
+			Workspace<T>& workspace,
+			T const& epsilon,
+			Pivot const& pivot,
+			std::size_t const& n_right = 0)
+		{
+			auto const n_rows = std::get<0>(matrix.size());
+			auto const n_columns = std::get<1>(matrix.size()) - n_right;
+
+			// Rows that are updated, the extra rows of an overdetermined matrix
+			// are only needed if they can still become a pivot row
+			std::size_t const n_active = (pivot == Pivot::Diagonal) ? n_columns : n_rows;
+
+			// Matrix row of each row, rows are reordered by swapping indices only
+			std::pmr::vector<std::size_t>& order = workspace.origin;
+
+			bool const parallel = workspace.pool && (workspace.pool->size() > 1) && (n_columns >= workspace.parallel_threshold);
+
+			std::pmr::vector<std::size_t>& column_order = workspace.column_order;
+			if (pivot == Pivot::Full)
+			{
+				column_order.resize(n_columns);
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+					column_order[i] = i;
+			}
+
+			// Largest magnitude of the input, and of the pivot rows, for the pivot growth
+			Stats<T>* const stats = workspace.stats;
+			T largest_input{ 0 };
+			T largest_pivot{ 0 };
+			if (stats)
+				for (std::size_t row{ 0 }; row < n_active; ++row)
+					for (T const& value : std::as_const(matrix).row(order[row]))
+						largest_input = std::max<T>(largest_input, std::abs(value));
+
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+			{
+				if (pivot != Pivot::Diagonal)
+				{
+					// Search largest magnitude among remaining rows (and columns)
+					std::size_t const last_column = (pivot == Pivot::Full) ? n_columns : column + 1;
+					std::size_t pivot_row{ column };
+					std::size_t pivot_column{ column };
+					T largest{ 0 };
+					for (std::size_t row{ column }; row < n_rows; ++row)
+						for (std::size_t k{ column }; k < last_column; ++k)
+							if (std::abs(matrix.at_unchecked(order[row], k)) > largest)
+							{
+								largest = std::abs(matrix.at_unchecked(order[row], k));
+								pivot_row = row;
+								pivot_column = k;
+							}
+
+					// Singular matrix
+					if (largest < epsilon)
+						return Fail(workspace, Failure::SingularPivot);
+
+					std::swap(order[column], order[pivot_row]);
+					if (!equal.empty())
+						std::swap(equal[column], equal[pivot_row]);
+					if (pivot_column != column)
+					{
+						for (std::size_t row{ 0 }; row < n_rows; ++row)
+							std::swap(matrix.at_unchecked(row, column), matrix.at_unchecked(row, pivot_column));
+						std::swap(column_order[column], column_order[pivot_column]);
+					}
+				}
+
+				// Scalars of all rows first, so that the right hand side
+				// can be updated in one vectorized pass
+				std::pmr::vector<T>& scalar = workspace.scalar;
+				scalar.resize(n_active);
+				for (std::size_t row{ 0 }; row < n_active; ++row)
+				{
+					scalar[row] = (row == column) ? T{ 0 } : matrix.at_unchecked(order[row], column) / matrix.at_unchecked(order[column], column);
+					if (!std::isfinite(scalar[row]))
+						return Fail(workspace, Failure::NonFiniteScalar);
+				}
+
+				// Rows are independent of each other for a given column
+				std::span<T const> const source = std::as_const(matrix).row(order[column]);
+				if (stats)
+					for (T const& value : source)
+						largest_pivot = std::max<T>(largest_pivot, std::abs(value));
+				auto const update = [&](std::size_t const begin, std::size_t const end)
+					{
+						for (std::size_t row{ begin }; row < end; ++row)
+							if (row != column)
+								Detail::Axpy<T>(matrix.row(order[row]), source, scalar[row]);
+					};
+
+				if (parallel)
+					workspace.pool->parallel_for(n_active, [&](std::size_t begin, std::size_t end, std::size_t)
+						{
+							update(begin, end);
+						});
+				else
+					update(0, n_active);
+
+				if (!equal.empty())
+				{
+					T const pivot_equal = equal[column];
+					Detail::Axpy<T>(equal.first(n_active), scalar, pivot_equal);
+				}
+			}
+
+			if (stats)
+				stats->pivot_growth = largest_pivot / largest_input;
+
+			// Rescale diagonal to 1, to get result
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+			{
+				T const diagonal = matrix.at_unchecked(order[i], i);
+				for (T& value : matrix.row(order[i]).subspan(n_columns))
+				{
+					value /= diagonal;
+					if (!std::isfinite(value))
+						return Fail(workspace, Failure::NonFiniteResult);
+				}
+
+				if (equal.empty())
+					continue;
+
+				T value = equal[i] / diagonal;
+				if (!std::isfinite(value))
+					return Fail(workspace, Failure::NonFiniteResult);
+
+				equal[i] = value;
+			}
+
+			// Undo the column reordering
+			if ((pivot == Pivot::Full) && !equal.empty())
+			{
+				std::pmr::vector<T>& scratch = workspace.scratch;
+				scratch.assign(equal.begin(), equal.begin() + n_columns);
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+					equal[column_order[i]] = scratch[i];
+			}
+
+			return true;
+		};
+
+	};
+
+	namespace Detail
+	{
+
+		// Initial row order of the elimination, in workspace.origin.
+		// The diagonal method needs a non-zero diagonal, so it may reorder the rows,
+		// then equal (if not empty) is put in the same order
+		template<typename T>
+		bool OrderRows(
+			Matrix<T> const& matrix,
+			std::span<T> equal,
+			Workspace<T>& workspace,
+			T const& epsilon,
+			Pivot const& pivot)
+		{
+			auto const n_rows = std::get<0>(matrix.size());
+			std::pmr::vector<std::size_t>& origin = workspace.origin;
+			if ((pivot == Pivot::Diagonal) && !matrix.is_diagonal_nonzero(epsilon))
+			{
+				if (workspace.stats)
+					workspace.stats->reordered = true;
+				if (UseCache(matrix, workspace, epsilon))
+				{
+					if (workspace.stats)
+						workspace.stats->cached = true;
+				}
+				else
+				{
+					if (!ReorderDiagonal(matrix, workspace, epsilon))
+						return false;
+					if (workspace.cache)
+						workspace.cache->origin.assign(origin.begin(), origin.end());
+				}
+				if (!equal.empty())
+					PermuteEqual(equal, workspace);
+			}
+			else
+			{
+				origin.resize(n_rows);
+				for (std::size_t i{ 0 }; i < n_rows; ++i)
+					origin[i] = i;
+			}
+
+			return true;
+		};
+
+	};
+
+	// Gauss Jordan elimination, destroying the input.
+	// On success the first n_columns entries of equal hold the result,
+	// and workspace.origin the input row used for each pivot.
+	// Unlike Solve it does not retry when a cached row order fails,
+	// as the input is already changed; use Solve with a PivotCache
+	template<typename T>
+	bool SolveInPlace(
+		Matrix<T>& matrix,
+		std::span<std::type_identity_t<T>> equal,
+		Workspace<T>& workspace,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		Stats<T>* const stats = workspace.stats;
+		Clock::time_point start{};
+		if (stats)
+		{
+			*stats = {};
+			start = Clock::now();
+		}
+
+		if (!matrix.is_valid())
+			return Detail::Fail(workspace, Failure::InvalidInput);
+
+		auto const [n_rows, n_columns] = matrix.size();
+
+		if (n_rows != equal.size())
+			return Detail::Fail(workspace, Failure::InvalidInput);
+
+		if (!Detail::OrderRows(matrix, equal, workspace, epsilon, pivot))
+			return false;
+
+		if (stats)
+		{
+			Clock::time_point const now = Clock::now();
+			stats->reorder_time = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start);
+			start = now;
+		}
+
+		// Solve as a square matrix
+		bool const solved = Detail::Eliminate(matrix, equal, workspace, epsilon, pivot);
+
+		if (stats)
+			stats->eliminate_time = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+
+		return solved;
+	};
+
+	// Gauss Jordan elimination, destroying the input.
+	// On success the first n_columns entries of equal hold the result
+	template<typename T>
+	bool SolveInPlace(
+		Matrix<T>& matrix,
+		std::span<std::type_identity_t<T>> equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		Workspace<T> workspace;
+		return SolveInPlace(matrix, equal, workspace, epsilon, pivot);
+	};
+
+	// Gauss Jordan elimination, using caller provided memory.
+	// Result is empty on failure
+	template<typename T>
+	bool Solve(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		Workspace<T>& workspace,
+		std::vector<T>& result,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		result.clear();
+
+		workspace.matrix = matrix;
+		workspace.equal.assign(equal.begin(), equal.end());
+		std::size_t const hits = workspace.cache ? workspace.cache->hits : 0;
+		if (!SolveInPlace(workspace.matrix, workspace.equal, workspace, epsilon, pivot))
+		{
+			// The cached row order may fail where the searched one does not
+			if (!workspace.cache || (workspace.cache->hits == hits))
+				return false;
+
+			workspace.cache->origin.clear();
+			workspace.matrix = matrix;
+			workspace.equal.assign(equal.begin(), equal.end());
+			if (!SolveInPlace(workspace.matrix, workspace.equal, workspace, epsilon, pivot))
+				return false;
+		}
+
+		auto const n_columns = std::get<1>(matrix.size());
+		result.assign(workspace.equal.begin(), workspace.equal.begin() + n_columns);
+
+		return true;
+	};
+
+	// Gauss Jordan elimination, row updates of large matrices
+	// are split across the threads of pool
+	template<typename T>
+	std::vector<T> Solve(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		ThreadPool& pool,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		Workspace<T> workspace;
+		workspace.pool = &pool;
+
+		std::vector<T> result;
+		Solve(matrix, equal, workspace, result, epsilon, pivot);
+
+		return result;
+	};
+
+	// Gauss Jordan elimination
+	template<typename T>
+	std::vector<T> Solve(
+		Matrix<T> matrix,
+		std::vector<T> equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		if (!SolveInPlace(matrix, equal, epsilon, pivot))
+			return {};
+
+		equal.resize(std::get<1>(matrix.size()));
+
+		return equal;
+	};
+
+	// Gauss Jordan elimination with several right hand sides, the columns of equal.
+	// They are carried along in the rows of the matrix, so all are eliminated
+	// in one pass over it. Result has a column per right hand side,
+	// it is empty on failure
+	template<typename T>
+	Matrix<T> Solve(
+		Matrix<T> const& matrix,
+		Matrix<T> const& equal,
+		Workspace<T>& workspace,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		if (workspace.stats)
+			*workspace.stats = {};
+
+		if (!matrix.is_valid())
+		{
+			Detail::Fail(workspace, Failure::InvalidInput);
+			return {};
+		}
+
+		auto const [n_rows, n_columns] = matrix.size();
+		auto const n_right = std::get<1>(equal.size());
+
+		// Any number of right hand sides, one value per row each
+		if ((n_rows != std::get<0>(equal.size())) || !n_right)
+		{
+			Detail::Fail(workspace, Failure::InvalidInput);
+			return {};
+		}
+
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+			if (!Detail::AllFinite(equal.row(i)))
+			{
+				Detail::Fail(workspace, Failure::InvalidInput);
+				return {};
+			}
+
+		if (!Detail::OrderRows(matrix, std::span<T>{}, workspace, epsilon, pivot))
+			return {};
+
+		// The matrix with the right hand sides appended to each row
+		Matrix<T>& system = workspace.matrix;
+		system.resize(n_rows, n_columns + n_right);
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+		{
+			std::span<T> const target = system.row(i);
+			std::ranges::copy(matrix.row(i), target.begin());
+			std::ranges::copy(equal.row(i), target.begin() + n_columns);
+		}
+
+		if (!Detail::Eliminate(system, std::span<T>{}, workspace, epsilon, pivot, n_right))
+			return {};
+
+		Matrix<T> result(n_columns, n_right, matrix.resource());
+		for (std::size_t i{ 0 }; i < n_columns; ++i)
+		{
+			std::size_t const row = (pivot == Pivot::Full) ? workspace.column_order[i] : i;
+			std::ranges::copy(std::as_const(system).row(workspace.origin[i]).subspan(n_columns), result.row(row).begin());
+		}
+
+		return result;
+	};
+
+	// Gauss Jordan elimination with several right hand sides, the columns of equal
+	template<typename T>
+	Matrix<T> Solve(
+		Matrix<T> const& matrix,
+		Matrix<T> const& equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		Workspace<T> workspace;
+		return Solve(matrix, equal, workspace, epsilon, pivot);
+	};
+
+	// Inverse of a square matrix, empty on failure.
+	// Partial pivoting by default, as the identity gives no preference for the diagonal
+	template<typename T>
+	Matrix<T> Inverse(
+		Matrix<T> const& matrix,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Partial)
+	{
+		auto const [n_rows, n_columns] = matrix.size();
+		if (!matrix.is_valid() || (n_rows != n_columns))
+			return {};
+
+		Matrix<T> identity(n_rows, n_rows, matrix.resource());
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+			identity.at_unchecked(i, i) = 1;
+
+		return Solve(matrix, identity, epsilon, pivot);
+	};
+
+	namespace Detail
+	{
+
+		// Appends the rows Solve uses for the diagonal of matrix to rows,
+		// one per column. False if there are none
+		template<typename T>
+		bool AppendDiagonalRows(
+			Matrix<T> const& matrix,
+			Workspace<T>& workspace,
+			T const& epsilon,
+			std::vector<std::size_t>& rows)
+		{
+			std::size_t const n_columns = std::get<1>(matrix.size());
+			if (matrix.is_diagonal_nonzero(epsilon))
+				for (std::size_t row{ 0 }; row < n_columns; ++row)
+					rows.push_back(row);
+			else if (SearchDiagonal(matrix, workspace, epsilon))
+				rows.insert(rows.end(), workspace.diagonal.begin(), workspace.diagonal.end());
+			else
+				return false;
+
+			return true;
+		};
+
+		// Lockstep Gauss Jordan elimination of n_lanes square systems,
+		// stored as structure of arrays: cell [row,column] of system s is at
+		// matrix[(row * n + column) * n_lanes + s] and equal[row] at equal[row * n_lanes + s].
+		// Each lane loop is one vectorized kernel call.
+		// check[s] is non-zero (NaN) afterwards if a scalar of system s is not finite
+		template<typename T>
+		void EliminateBatch(
+			std::span<T> matrix,
+			std::span<T> equal,
+			std::span<T> scalar,
+			std::span<T> check,
+			std::size_t const& n,
+			std::size_t const& n_lanes)
+		{
+			for (std::size_t column{ 0 }; column < n; ++column)
+			{
+				T const* const pivot = &matrix[(column * n + column) * n_lanes];
+				T const* const source = &matrix[column * n * n_lanes];
+				T const* const source_equal = &equal[column * n_lanes];
+				for (std::size_t row{ 0 }; row < n; ++row)
+					if (row != column)
+					{
+						T* const target = &matrix[row * n * n_lanes];
+
+						DivideLanes<T>(scalar.data(), target + column * n_lanes, pivot, check.data(), n_lanes);
+						AxpyLanes<T>(target, source, scalar.data(), n_lanes, n);
+						AxpyLanes<T>(&equal[row * n_lanes], source_equal, scalar.data(), n_lanes);
+					}
+			}
+		};
+
+	};
+
+	// Solve many independent systems, giving the same results as Solve.
+	// With the diagonal method, systems of the same size are packed as structure
+	// of arrays, so that the inner loops run across systems and use SIMD lanes.
+	// Partial and full pivoting choose the rows during elimination, so each
+	// system is then solved on its own, with one Workspace for all of them.
+	// results gets one entry per system, empty if that system could not be solved.
+	// Its memory is reused, so repeated batches of the same shape do not allocate for it
+	template<typename T>
+	void SolveBatch(
+		std::span<Matrix<T> const> matrices,
+		std::span<std::vector<T> const> equals,
+		std::vector<std::vector<T>>& results,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		if (matrices.size() != equals.size())
+		{
+			results.clear();
+			return;
+		}
+
+		std::size_t const n_systems = matrices.size();
+		results.resize(n_systems);
+
+		if (pivot != Pivot::Diagonal)
+		{
+			Workspace<T> workspace;
+			for (std::size_t i{ 0 }; i < n_systems; ++i)
+				Solve(matrices[i], equals[i], workspace, results[i], epsilon, pivot);
+
+			return;
+		}
+
+		for (std::vector<T>& result : results)
+			result.clear();
+
+		// Systems that are packed, with the rows used for them
+		std::vector<std::size_t> group;
+		std::vector<std::size_t> rows;
+		std::vector<bool> done(n_systems, false);
+		Workspace<T> workspace;
+
+		std::vector<T> batch_matrix, batch_equal, scalar, check, solution;
+
+		for (std::size_t first{ 0 }; first < n_systems; ++first)
+		{
+			if (done[first])
+				continue;
+
+			auto const [n_rows, n_columns] = matrices[first].size();
+
+			// Collect systems of the same size, the rows for the
+			// diagonal are chosen the same way as in Solve
+			group.clear();
+			rows.clear();
+			for (std::size_t i{ first }; i < n_systems; ++i)
+			{
+				Matrix<T> const& matrix = matrices[i];
+				if (done[i] || (matrix.size() != matrices[first].size()))
+					continue;
+
+				done[i] = true;
+				if (!matrix.is_valid() || (equals[i].size() != n_rows))
+					continue;
+
+				if (Detail::AppendDiagonalRows<T>(matrix, workspace, epsilon, rows))
+					group.push_back(i);
+			}
+
+			// Pack at most as many systems as fit in the L1 data cache,
+			// in multiples of a full vector of lanes
+			std::size_t constexpr lane_multiple{ 16 };
+			std::size_t const system_size = n_columns * (n_columns + 1) * sizeof(T);
+			std::size_t const max_lanes = std::clamp<std::size_t>((1 << 15) / std::max<std::size_t>(system_size, 1), 1, 64);
+
+			for (std::size_t start{ 0 }; start < group.size(); start += max_lanes)
+			{
+				std::size_t const n_used = std::min(max_lanes, group.size() - start);
+				std::size_t const n_lanes = ((n_used + lane_multiple - 1) / lane_multiple) * lane_multiple;
+
+				// Unused lanes hold the identity, which solves without rounding
+				batch_matrix.assign(n_columns * n_columns * n_lanes, T{ 0 });
+				batch_equal.assign(n_columns * n_lanes, T{ 0 });
+				scalar.resize(n_lanes);
+				check.assign(n_lanes, T{ 0 });
+				solution.resize(n_columns * n_lanes);
+				for (std::size_t s{ n_used }; s < n_lanes; ++s)
+					for (std::size_t i{ 0 }; i < n_columns; ++i)
+						batch_matrix[(i * n_columns + i) * n_lanes + s] = 1;
+
+				for (std::size_t s{ 0 }; s < n_used; ++s)
+				{
+					std::size_t const index = group[start + s];
+					for (std::size_t row{ 0 }; row < n_columns; ++row)
+					{
+						std::size_t const source_row = rows[(start + s) * n_columns + row];
+						std::span<T const> const source = matrices[index].row(source_row);
+						for (std::size_t column{ 0 }; column < n_columns; ++column)
+							batch_matrix[(row * n_columns + column) * n_lanes + s] = source[column];
+						batch_equal[row * n_lanes + s] = equals[index][source_row];
+					}
+				}
+
+				Detail::EliminateBatch<T>(batch_matrix, batch_equal, scalar, check, n_columns, n_lanes);
+
+				// Rescale diagonal to 1, to get result
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+					Detail::DivideLanes<T>(&solution[i * n_lanes], &batch_equal[i * n_lanes],
+						&batch_matrix[(i * n_columns + i) * n_lanes], check.data(), n_lanes);
+
+				for (std::size_t s{ 0 }; s < n_used; ++s)
+				{
+					if (check[s] != 0)
+						continue;
+
+					std::vector<T>& result = results[group[start + s]];
+					result.resize(n_columns);
+					for (std::size_t i{ 0 }; i < n_columns; ++i)
+						result[i] = solution[i * n_lanes + s];
+				}
+			}
+		}
+	};
+
+	// Solve many independent systems, giving the same results as Solve.
+	// A result is empty if that system could not be solved
+	template<typename T>
+	std::vector<std::vector<T>> SolveBatch(
+		std::span<Matrix<T> const> matrices,
+		std::span<std::vector<T> const> equals,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		std::vector<std::vector<T>> results;
+		SolveBatch(matrices, equals, results, epsilon, pivot);
+
+		return results;
+	};
+
+	template<typename T>
+	std::vector<std::vector<T>> SolveBatch(
+		std::vector<Matrix<T>> const& matrices,
+		std::vector<std::vector<T>> const& equals,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		return SolveBatch(std::span<Matrix<T> const>(matrices), std::span<std::vector<T> const>(equals), epsilon, pivot);
+	};
+
+	namespace Detail
+	{
+
+		// Residual equal - matrix * result of every row,
+		// returns the sum of magnitudes as ErrorEstimate does
+		template<typename T>
+		T Residual(
+			Matrix<T> const& matrix,
+			std::span<T const> equal,
+			std::span<T const> result,
+			std::span<T> residual)
+		{
+			auto const n_rows = std::get<0>(matrix.size());
+
+			T error{ 0 };
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+			{
+				std::span<T const> const row = matrix.row(i);
+				T sum{ 0 };
+				for (std::size_t j{ 0 }; j < row.size(); ++j)
+					sum += row[j] * result[j];
+
+				residual[i] = equal[i] - sum;
+				error += std::abs(sum - equal[i]);
+			}
+
+			return error;
+		};
+
+		// Sum of a[i] * b[i], in independent lanes so the loop can use vector instructions
+		template<typename T>
+		T Dot(
+			std::span<T const> a,
+			std::span<T const> b)
+		{
+			std::size_t constexpr lanes{ 8 };
+			std::array<T, lanes> sum{};
+
+			std::size_t i{ 0 };
+			for (; i + lanes <= a.size(); i += lanes)
+				for (std::size_t k{ 0 }; k < lanes; ++k)
+					sum[k] += a[i + k] * b[i + k];
+			for (; i < a.size(); ++i)
+				sum[0] += a[i] * b[i];
+
+			T total{ 0 };
+			for (T const& value : sum)
+				total += value;
+
+			return total;
+		};
+
+	};
+
+	// Solution of Solve with its residual, equal - matrix * result
+	template<typename T = Real>
+	struct Solution final
+	{
+		std::vector<T> result{};
+
+		// Sum of magnitudes of the residual, as ErrorEstimate
+		T error{ NaN_v<T> };
+
+		// Largest magnitude of the residual
+		T max_error{ NaN_v<T> };
+
+		// Residual of each row, only if requested
+		std::vector<T> residual{};
+	};
+
+	// Convenience wrapper: Solve, then one residual pass over the rows of matrix.
+	// The residual needs the final result, so it is not fused into the elimination.
+	// Error may differ from ErrorEstimate in the last bits, as the sums are split
+	// into lanes. Result is empty, and errors NaN, on failure
+	template<typename T>
+	bool SolveWithResidual(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		Workspace<T>& workspace,
+		Solution<T>& solution,
+		bool const& keep_residual = false,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		solution.error = NaN_v<T>;
+		solution.max_error = NaN_v<T>;
+		solution.residual.clear();
+
+		if (!Solve(matrix, equal, workspace, solution.result, epsilon, pivot))
+			return false;
+
+		auto const n_rows = std::get<0>(matrix.size());
+		if (keep_residual)
+			solution.residual.resize(n_rows);
+
+		T error{ 0 };
+		T max_error{ 0 };
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+		{
+			T const residual = equal[i] - Detail::Dot<T>(matrix.row(i), solution.result);
+			error += std::abs(residual);
+			max_error = std::max<T>(max_error, std::abs(residual));
+			if (keep_residual)
+				solution.residual[i] = residual;
+		}
+
+		solution.error = error;
+		solution.max_error = max_error;
+		return true;
+	};
+
+	// Solve, then compute the residual
+	template<typename T>
+	Solution<T> SolveWithResidual(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		bool const& keep_residual = false,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		Workspace<T> workspace;
+		Solution<T> solution;
+		SolveWithResidual(matrix, equal, workspace, solution, keep_residual, epsilon, pivot);
+
+		return solution;
+	};
+
+	// For a square matrix this should be zero.
+	// An overdetermined matrix has more equations than unknowns,
+	// so the result may not be correct for all of them
+	// TODO Mathness: does this have a proper name?
+	template<typename T>
+	T ErrorEstimate(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		std::vector<T> const& result)
+	{
+		if (!matrix.is_valid())
+			return NaN_v<T>;
+
+		auto const [n_rows, n_columns] = matrix.size();
+
+		if ((n_rows != equal.size()) || (n_columns != result.size()))
+			return NaN_v<T>;
+
+		T error{ 0 };
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+		{
+			T sum{ 0 };
+			for (std::size_t j{ 0 };j < n_columns;++j)
+				sum += matrix.at_unchecked(i, j) * result[j];
+
+			error += std::abs(sum - equal[i]);
+		}
+
+		return error;
+	};
+
+	// Solution of one point of a sweep, result is empty
+	// and error is NaN if the system could not be solved
+	template<typename T = Real>
+	struct SweepPoint final
+	{
+		T parameter{ 0 };
+		std::vector<T> result{};
+		T error{ NaN_v<T> };
+	};
+
+	// Solve a family of systems, one for each parameter value.
+	// Each thread works on its own copy of matrix and equal, which
+	// build(parameter, matrix, equal) changes for each point before it is solved.
+	// build is called from several threads at once. Results are in parameter order.
+	// Points are solved in fixed blocks, each on one thread and starting with an
+	// empty PivotCache, so a point reuses the row order of the previous points
+	// of its block only. Results do not depend on the threads or their scheduling
+	template<typename T, typename Builder>
+	std::vector<SweepPoint<T>> Sweep(
+		ThreadPool& pool,
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		Builder&& build,
+		std::span<std::type_identity_t<T> const> parameters,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		std::vector<SweepPoint<T>> points(parameters.size());
+
+		// Per thread system and scratch memory
+		struct Local
+		{
+			Matrix<T> matrix;
+			std::vector<T> equal;
+			Workspace<T> workspace{};
+			PivotCache cache{};
+		};
+		std::vector<Local> local(pool.size(), Local{ matrix, equal });
+		for (Local& own : local)
+			own.workspace.cache = &own.cache;
+
+		std::size_t constexpr block{ 16 };
+		std::size_t const n_blocks = (parameters.size() + block - 1) / block;
+
+		pool.parallel_for(n_blocks, [&](std::size_t const& begin, std::size_t const& end, std::size_t const& thread)
+			{
+				Local& own = local[thread];
+				for (std::size_t b{ begin }; b < end; ++b)
+				{
+					own.cache.clear();
+					for (std::size_t i{ b * block }; i < std::min((b + 1) * block, parameters.size()); ++i)
+					{
+						SweepPoint<T>& point = points[i];
+						point.parameter = parameters[i];
+						build(std::as_const(point.parameter), own.matrix, own.equal);
+
+						if (Solve(own.matrix, own.equal, own.workspace, point.result, epsilon, pivot))
+							point.error = ErrorEstimate(own.matrix, own.equal, point.result);
+					}
+				}
+			});
+
+		return points;
+	};
+
+	// Same as above, at parameter = first + step * i for i in [0, count)
+	template<typename T, typename Builder>
+	std::vector<SweepPoint<T>> Sweep(
+		ThreadPool& pool,
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		Builder&& build,
+		std::type_identity_t<T> const& first,
+		std::type_identity_t<T> const& step,
+		std::size_t const& count,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		std::vector<T> parameters(count);
+		for (std::size_t i{ 0 }; i < count; ++i)
+			parameters[i] = first + step * i;
+
+		return Sweep(pool, matrix, equal, std::forward<Builder>(build), std::span<T const>(parameters), epsilon, pivot);
+	};
+
+	// Buffered text output, numbers are formatted with std::to_chars straight
+	// into a reusable buffer, which is written to the stream in large blocks.
+	// Numbers are formatted as std::ostream does by default (%g), without allocation.
+	// With space_sign a space is written before non-negative floating point values,
+	// as by the ' ' option of std::format (and so RealToString)
+	class Writer final
+	{
+
+	private:
+
+		std::ostream& stream;
+		std::vector<char> buffer;
+		std::size_t used{ 0 };
+		int precision;
+		bool space_sign;
+
+		// Make room for count characters
+		char* reserve(
+			std::size_t const& count)
+		{
+			if (buffer.size() - used < count)
+				flush();
+			return buffer.data() + used;
+		};
+
+	public:
+
+		explicit Writer(
+			std::ostream& stream,
+			int const& precision = 6,
+			std::size_t const& capacity = 1 << 16,
+			bool const& space_sign = false)
+			: stream(stream), buffer(std::max<std::size_t>(capacity, 256)), precision(precision), space_sign(space_sign)
+		{};
+
+		Writer(Writer const&) = delete;
+		Writer& operator = (Writer const&) = delete;
+
+		~Writer()
+		{
+			flush();
+		};
+
+		// Write the buffer to the stream
+		void flush()
+		{
+			if (used)
+				stream.write(buffer.data(), used);
+			used = 0;
+		};
+
+		// As std::ostream, bool is written as 1 or 0 and single byte character types
+		// as the character. Wider character types are rejected, as std::ostream does
+		template<typename T>
+			requires (std::is_arithmetic_v<T> && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>)
+		Writer& operator << (
+			T const& value)
+		{
+			// Longest %g output, sign, digits, point and exponent
+			std::size_t constexpr margin{ 32 };
+
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				*reserve(1) = value ? '1' : '0';
+				++used;
+			}
+			else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char> || std::is_same_v<T, char8_t>)
+			{
+				*reserve(1) = static_cast<char>(value);
+				++used;
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				char* const first = reserve(margin);
+				used += std::to_chars(first, buffer.data() + buffer.size(), value).ptr - first;
+			}
+			else
+			{
+				std::size_t const p = std::min<std::size_t>(std::max(precision, 1), buffer.size() - margin);
+				char* first = reserve(p + margin);
+				if (space_sign && !std::signbit(value))
+					*first++ = ' ';
+				used = std::to_chars(first, buffer.data() + buffer.size(), value, std::chars_format::general, p).ptr - buffer.data();
+			}
+
+			return *this;
+		};
+
+		Writer& operator << (
+			std::string_view const& text)
+		{
+			if (text.size() > buffer.size())
+			{
+				flush();
+				stream.write(text.data(), text.size());
+				return *this;
+			}
+
+			std::copy(text.begin(), text.end(), reserve(text.size()));
+			used += text.size();
+
+			return *this;
+		};
+
+	};
+
+	// Read only view of a whole file, memory mapped where supported,
+	// otherwise read into memory. Empty if the file can not be read
+	class MappedFile final
+	{
+
+	private:
+
+#if defined(GAUSS_JORDAN_MMAP)
+		void* address{ nullptr };
+#else
+		std::vector<std::byte> content{};
+#endif
+		std::size_t length{ 0 };
+
+		void release()
+		{
+#if defined(GAUSS_JORDAN_MMAP)
+			if (address)
+				::munmap(address, length);
+			address = nullptr;
+#else
+			content.clear();
+#endif
+			length = 0;
+		};
+
+	public:
+
+		MappedFile() {};
+
+		explicit MappedFile(
+			std::string const& path)
+		{
+#if defined(GAUSS_JORDAN_MMAP)
+			int const file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0)
+				return;
+
+			struct stat status;
+			if ((::fstat(file, &status) == 0) && (status.st_size > 0))
+			{
+				void* const mapped = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+				if (mapped != MAP_FAILED)
+				{
+					address = mapped;
+					length = static_cast<std::size_t>(status.st_size);
+				}
+			}
+			::close(file);
+#else
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+				return;
+
+			std::streamsize const size = file.tellg();
+			if (size <= 0)
+				return;
+
+			content.resize(static_cast<std::size_t>(size));
+			file.seekg(0);
+			if (!file.read(reinterpret_cast<char*>(content.data()), size))
+			{
+				content.clear();
+				return;
+			}
+			length = content.size();
+#endif
+		};
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator = (MappedFile const&) = delete;
+
+		MappedFile(
+			MappedFile&& other) noexcept
+		{
+			*this = std::move(other);
+		};
+
+		MappedFile& operator = (
+			MappedFile&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+#if defined(GAUSS_JORDAN_MMAP)
+				address = std::exchange(other.address, nullptr);
+#else
+				content = std::move(other.content);
+#endif
+				length = std::exchange(other.length, 0);
+			}
+			return *this;
+		};
+
+		~MappedFile()
+		{
+			release();
+		};
+
+		// Contents of the file, valid as long as this object
+		std::span<std::byte const> data() const
+		{
+#if defined(GAUSS_JORDAN_MMAP)
+			return { static_cast<std::byte const*>(address), length };
+#else
+			return content;
+#endif
+		};
+
+		// True if the file was read, and is not empty
+		bool is_valid() const
+		{
+			return length;
+		};
+
+	};
+
+	// Header of the binary sweep format. It is followed, at offset, by n_records
+	// records of parameter, error and n_values result values, all of one
+	// floating point type in native byte order. Failed points have NaN error and result
+	struct SweepHeader final
+	{
+		std::array<char, 8> magic{ 'G', 'J', 'S', 'W', 'E', 'E', 'P', '\0' };
+		uint32_t version{ 1 };
+		uint32_t byte_order{ 0x01020304 };
+		uint32_t value_size{ 0 };
+		uint32_t value_digits{ 0 };
+		uint64_t n_values{ 0 };
+		uint64_t n_records{ 0 };
+		// Records start on a cache line
+		uint64_t offset{ 64 };
+	};
+
+	// Write sweep results in the binary sweep format. False if the stream failed
+	template<typename T>
+	bool WriteSweep(
+		std::ostream& stream,
+		std::vector<SweepPoint<T>> const& points)
+	{
+		SweepHeader header;
+		header.value_size = sizeof(T);
+		header.value_digits = std::numeric_limits<T>::digits;
+		header.n_records = points.size();
+		for (SweepPoint<T> const& point : points)
+			header.n_values = std::max<uint64_t>(header.n_values, point.result.size());
+
+		std::array<char, 64> start{};
+		static_assert(sizeof(SweepHeader) <= start.size());
+		std::memcpy(start.data(), &header, sizeof(SweepHeader));
+		stream.write(start.data(), start.size());
+
+		// Records are written through one reused buffer
+		std::vector<T> record(2 + header.n_values);
+		for (SweepPoint<T> const& point : points)
+		{
+			record[0] = point.parameter;
+			record[1] = point.error;
+			std::fill(std::copy(point.result.begin(), point.result.end(), record.begin() + 2), record.end(), NaN_v<T>);
+			stream.write(reinterpret_cast<char const*>(record.data()), record.size() * sizeof(T));
+		}
+
+		return stream.good();
+	};
+
+	// Records of a binary sweep file, read in place without copying
+	// (such as from a MappedFile). The data must outlive the view
+	template<typename T = Real>
+	class SweepView final
+	{
+
+	private:
+
+		std::span<T const> values{};
+		std::size_t n_values{ 0 };
+		std::size_t n_records{ 0 };
+		bool valid{ false };
+
+		std::size_t record(
+			std::size_t const& index) const
+		{
+			return index * (2 + n_values);
+		};
+
+	public:
+
+		SweepView() {};
+
+		// Invalid if the header does not match T, or the data is too short
+		explicit SweepView(
+			std::span<std::byte const> data)
+		{
+			SweepHeader header;
+			SweepHeader const expected;
+			if (data.size() < sizeof(SweepHeader))
+				return;
+			std::memcpy(&header, data.data(), sizeof(SweepHeader));
+
+			if ((header.magic != expected.magic) || (header.version != expected.version) ||
+				(header.byte_order != expected.byte_order) || (header.value_size != sizeof(T)) ||
+				(header.value_digits != std::numeric_limits<T>::digits) || (header.offset > data.size()))
+				return;
+
+			// The counts come from the file, so they are checked by division,
+			// a product that wraps around could otherwise pass
+			std::size_t const available = (data.size() - header.offset) / sizeof(T);
+			if ((header.n_values > available) || (header.n_records > available / (2 + header.n_values)))
+				return;
+
+			std::size_t const count = (2 + header.n_values) * header.n_records;
+			std::byte const* const first = data.data() + header.offset;
+			if (reinterpret_cast<std::uintptr_t>(first) % alignof(T))
+				return;
+
+			values = std::span<T const>(reinterpret_cast<T const*>(first), count);
+			n_values = header.n_values;
+			n_records = header.n_records;
+			valid = true;
+		};
+
+		// True if the data is a sweep file of type T
+		bool is_valid() const
+		{
+			return valid;
+		};
+
+		// Number of records
+		std::size_t size() const
+		{
+			return n_records;
+		};
+
+		T parameter(
+			std::size_t const& index) const
+		{
+			if (index >= n_records)
+				return NaN_v<T>;
+
+			return values[record(index)];
+		};
+
+		T error(
+			std::size_t const& index) const
+		{
+			if (index >= n_records)
+				return NaN_v<T>;
+
+			return values[record(index) + 1];
+		};
+
+		std::span<T const> result(
+			std::size_t const& index) const
+		{
+			if (index >= n_records)
+				return {};
+
+			return values.subspan(record(index) + 2, n_values);
+		};
+
+	};
+
+	// Convert a binary sweep to the gnuplot text format, "parameter  error" per
+	// line, for records with a finite error, formatted as by Writer.
+	// False if the view or stream is not valid
+	template<typename T>
+	bool SweepToText(
+		SweepView<T> const& view,
+		std::ostream& stream,
+		int const& precision = 6,
+		bool const& space_sign = false)
+	{
+		if (!view.is_valid())
+			return false;
+
+		{
+			Writer writer(stream, precision, 1 << 16, space_sign);
+			for (std::size_t i{ 0 }; i < view.size(); ++i)
+				if (std::isfinite(view.error(i)))
+					writer << view.parameter(i) << "  " << view.error(i) << '\n';
+		}
+
+		return stream.good();
+	};
+
+	// Header of the binary system format. It is followed, at offset, by the
+	// matrix in row-major order and then the n_rows values of the right hand side,
+	// all of one floating point type in native byte order
+	struct SystemHeader final
+	{
+		std::array<char, 8> magic{ 'G', 'J', 'S', 'Y', 'S', 'T', 'E', 'M' };
+		uint32_t version{ 1 };
+		uint32_t byte_order{ 0x01020304 };
+		uint32_t value_size{ 0 };
+		uint32_t value_digits{ 0 };
+		uint64_t n_rows{ 0 };
+		uint64_t n_columns{ 0 };
+		// Values start on a cache line
+		uint64_t offset{ 64 };
+	};
+
+	// Write a matrix and right hand side in the binary system format.
+	// False if the sizes do not match, or the stream failed
+	template<typename T>
+	bool WriteSystem(
+		std::ostream& stream,
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal)
+	{
+		auto const [n_rows, n_columns] = matrix.size();
+		if (n_rows != equal.size())
+			return false;
+
+		SystemHeader header;
+		header.value_size = sizeof(T);
+		header.value_digits = std::numeric_limits<T>::digits;
+		header.n_rows = n_rows;
+		header.n_columns = n_columns;
+
+		std::array<char, 64> start{};
+		static_assert(sizeof(SystemHeader) <= start.size());
+		std::memcpy(start.data(), &header, sizeof(SystemHeader));
+		stream.write(start.data(), start.size());
+
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+		{
+			std::span<T const> const row = matrix.row(i);
+			stream.write(reinterpret_cast<char const*>(row.data()), row.size() * sizeof(T));
+		}
+		stream.write(reinterpret_cast<char const*>(equal.data()), equal.size() * sizeof(T));
+
+		return stream.good();
+	};
+
+	// Matrix and right hand side of a binary system file, read in place
+	// without copying (such as from a MappedFile). The data must outlive the view
+	template<typename T = Real>
+	class SystemView final
+	{
+
+	private:
+
+		std::size_t n_rows{ 0 };
+		std::size_t n_columns{ 0 };
+		// Matrix followed by the right hand side
+		std::span<T const> values{};
+
+	public:
+
+		SystemView() {};
+
+		// Invalid if the header does not match T, or the data is too short
+		explicit SystemView(
+			std::span<std::byte const> data)
+		{
+			SystemHeader header;
+			SystemHeader const expected;
+			if (data.size() < sizeof(SystemHeader))
+				return;
+			std::memcpy(&header, data.data(), sizeof(SystemHeader));
+
+			if ((header.magic != expected.magic) || (header.version != expected.version) ||
+				(header.byte_order != expected.byte_order) || (header.value_size != sizeof(T)) ||
+				(header.value_digits != std::numeric_limits<T>::digits) || (header.offset > data.size()))
+				return;
+
+			// The counts come from the file, so they are checked by division,
+			// a product that wraps around could otherwise pass
+			std::size_t const available = (data.size() - header.offset) / sizeof(T);
+			if ((header.n_columns >= available) || (header.n_rows > available / (header.n_columns + 1)))
+				return;
+
+			std::size_t const count = header.n_rows * (header.n_columns + 1);
+			std::byte const* const first = data.data() + header.offset;
+			if (reinterpret_cast<std::uintptr_t>(first) % alignof(T))
+				return;
+
+			values = std::span<T const>(reinterpret_cast<T const*>(first), count);
+			n_rows = header.n_rows;
+			n_columns = header.n_columns;
+		};
+
+		// Returns number of rows and columns
+		std::tuple<std::size_t, std::size_t> size() const
+		{
+			return std::tuple(n_rows, n_columns);
+		};
+
+		// The matrix in row-major order, without padding
+		std::span<T const> matrix() const
+		{
+			return values.first(n_rows * n_columns);
+		};
+
+		// The right hand side
+		std::span<T const> right_hand_side() const
+		{
+			return values.last(n_rows);
+		};
+
+		// Copy into a Matrix and vector, with one finiteness check over all values.
+		// False if the view is empty or has values that are not finite
+		bool load(
+			Matrix<T>& matrix,
+			std::vector<T>& equal) const
+		{
+			if (!n_rows || !n_columns || !Detail::AllFinite(values))
+				return false;
+
+			Matrix<T> loaded(n_rows, n_columns);
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+			{
+				std::span<T const> const source = values.subspan(i * n_columns, n_columns);
+				std::copy(source.begin(), source.end(), loaded.row(i).begin());
+			}
+
+			matrix = std::move(loaded);
+			std::span<T const> const from = right_hand_side();
+			equal.assign(from.begin(), from.end());
+			return true;
+		};
+
+	};
+
+	// Tile sizes for the cache blocked factorization
+	struct Blocking final
+	{
+		// Number of columns eliminated together as a panel,
+		// before the rest of the matrix is updated
+		std::size_t panel{ 32 };
+
+		// Number of columns in one tile of the update of the rest
+		std::size_t tile{ 256 };
+	};
+
+	// LU factorization of a square or overdetermined matrix,
+	// for solving the same matrix with many right hand sides.
+	// The rows (and columns) are chosen the same way as in Solve.
+	// Except for full pivoting the elimination is blocked into panels,
+	// which gives the same result as without blocking
+	template<typename T = Real>
+	class Factorization final
+	{
+
+	private:
+
+		std::size_t n_rows{ 0 };
+		std::size_t n_columns{ 0 };
+
+		// L below the diagonal (with an implied unit diagonal), U on and above,
+		// stored in the first n_columns rows
+		Matrix<T> lu{};
+
+		// Original row of each row in lu
+		std::vector<std::size_t> row_order{};
+
+		// Column swapped with at each elimination step, when using full pivoting
+		std::vector<std::size_t> column_swap{};
+
+		// The factored matrix, with updated columns,
+		// kept to compute updates and to factor again
+		Matrix<T> source{};
+
+		// Settings of the factorization
+		T factor_epsilon{ 0 };
+		Pivot factor_pivot{ Pivot::Diagonal };
+		Blocking factor_blocking{};
+
+		// Column updates since the matrix was factored, in product form.
+		// Each replaces column position[k] (after column swaps) of the matrix,
+		// which adds u e' with u = new column - original column.
+		// Stored are w = B⁻¹ u with B the matrix before the update,
+		// and the original column, n_rows values each
+		std::vector<std::size_t> update_column_index{};
+		std::vector<std::size_t> update_position{};
+		std::vector<T> update_vector{};
+		std::vector<T> update_original{};
+
+		// Updates before factoring again
+		static std::size_t constexpr max_updates{ 8 };
+
+		// Errors in the solution grow by up to max(1, |w|) / |1 + w[p]| through each update
+		// (the Sherman-Morrison denominator), the matrix is factored again
+		// once the product over all updates is larger
+		static constexpr double max_growth{ 10 };
+
+		bool valid{ false };
+
+		bool factor()
+		{
+			column_swap.clear();
+			update_column_index.clear();
+			update_position.clear();
+			update_vector.clear();
+			update_original.clear();
+
+			row_order.resize(n_rows);
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+				row_order[i] = i;
+
+			// Rows are copied in the chosen order, so lu is stored in pivot order
+			if ((factor_pivot == Pivot::Diagonal) && !source.is_diagonal_nonzero(factor_epsilon))
+			{
+				Workspace<T> workspace;
+				if (!Detail::ReorderDiagonal(source, workspace, factor_epsilon))
+					return false;
+				row_order.assign(workspace.origin.begin(), workspace.origin.end());
+
+				lu.resize(n_rows, n_columns);
+				for (std::size_t i{ 0 }; i < n_rows; ++i)
+				{
+					std::span<T const> const from = source.row(row_order[i]);
+					std::copy(from.begin(), from.end(), lu.row(i).begin());
+				}
+			}
+			else
+				lu = source;
+
+			// Rows that are updated, the extra rows of an overdetermined matrix
+			// are only needed if they can still become a pivot row
+			std::size_t const n_active = (factor_pivot == Pivot::Diagonal) ? n_columns : n_rows;
+
+			if (factor_pivot == Pivot::Full)
+				column_swap.resize(n_columns);
+
+			// Full pivoting needs the whole remaining matrix up to date,
+			// so it is done as a single panel
+			std::size_t const panel = (factor_pivot == Pivot::Full) ? n_columns : std::max<std::size_t>(factor_blocking.panel, 1);
+			std::size_t const tile = std::max<std::size_t>(factor_blocking.tile, 1);
+
+			for (std::size_t first{ 0 }; first < n_columns; first += panel)
+			{
+				std::size_t const last = std::min(first + panel, n_columns);
+
+				// Panel factorization, updates are only applied to the panel columns
+				for (std::size_t column{ first }; column < last; ++column)
+				{
+					if (factor_pivot != Pivot::Diagonal)
+					{
+						// Search largest magnitude among remaining rows (and columns)
+						std::size_t const last_column = (factor_pivot == Pivot::Full) ? n_columns : column + 1;
+						std::size_t pivot_row{ column };
+						std::size_t pivot_column{ column };
+						T largest{ 0 };
+						for (std::size_t row{ column }; row < n_rows; ++row)
+							for (std::size_t k{ column }; k < last_column; ++k)
+								if (std::abs(lu.at_unchecked(row, k)) > largest)
+								{
+									largest = std::abs(lu.at_unchecked(row, k));
+									pivot_row = row;
+									pivot_column = k;
+								}
+
+						// Singular matrix
+						if (largest < factor_epsilon)
+							return false;
+
+						Detail::SwapRows(lu, {}, column, pivot_row);
+						std::swap(row_order[column], row_order[pivot_row]);
+						if (factor_pivot == Pivot::Full)
+						{
+							for (std::size_t row{ 0 }; row < n_rows; ++row)
+								std::swap(lu.at_unchecked(row, column), lu.at_unchecked(row, pivot_column));
+							column_swap[column] = pivot_column;
+						}
+					}
+
+					std::span<T const> const source = std::as_const(lu).row(column).subspan(column + 1, last - column - 1);
+					T const diagonal = lu.at_unchecked(column, column);
+					for (std::size_t row{ column + 1 }; row < n_active; ++row)
+					{
+						std::span<T> const target = lu.row(row);
+
+						T const scalar = target[column] / diagonal;
+						if (!std::isfinite(scalar))
+							return false;
+
+						target[column] = scalar;
+						Detail::Axpy<T>(target.subspan(column + 1, source.size()), source, scalar);
+					}
+				}
+
+				if (last == n_columns)
+					break;
+
+				// Rows of U right of the panel, forward substitution with the unit lower panel
+				for (std::size_t i{ first + 1 }; i < last; ++i)
+				{
+					std::span<T> const target = lu.row(i).subspan(last);
+					for (std::size_t j{ first }; j < i; ++j)
+						Detail::Axpy<T>(target, std::as_const(lu).row(j).subspan(last), lu.at_unchecked(i, j));
+				}
+
+				// Trailing update, minus the product of the panel's L and U parts.
+				// Done one tile of columns at a time, so the tile of U stays in cache
+				for (std::size_t tile_first{ last }; tile_first < n_columns; tile_first += tile)
+				{
+					std::size_t const width = std::min(tile, n_columns - tile_first);
+					for (std::size_t row{ last }; row < n_active; ++row)
+					{
+						std::span<T> const target = lu.row(row);
+						std::span<T> const target_tile = target.subspan(tile_first, width);
+						for (std::size_t j{ first }; j < last; ++j)
+							Detail::Axpy<T>(target_tile, std::as_const(lu).row(j).subspan(tile_first, width), target[j]);
+					}
+				}
+			}
+
+			return std::isfinite(1 / lu.at_unchecked(n_columns - 1, n_columns - 1));
+		};
+
+		// Forward and back substitution, without updates or column swaps
+		bool substitute(
+			std::span<T const> equal,
+			std::span<T> result) const
+		{
+			// Forward substitution, L has a unit diagonal
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+			{
+				std::span<T const> const row = lu.row(i);
+				T value = equal[row_order[i]];
+				for (std::size_t j{ 0 }; j < i; ++j)
+					value -= row[j] * result[j];
+				result[i] = value;
+			}
+
+			// Back substitution
+			for (std::size_t i{ n_columns }; i-- > 0;)
+			{
+				std::span<T const> const row = lu.row(i);
+				T value = result[i];
+				for (std::size_t j{ i + 1 }; j < n_columns; ++j)
+					value -= row[j] * result[j];
+				value /= row[i];
+				if (!std::isfinite(value))
+					return false;
+				result[i] = value;
+			}
+
+			return true;
+		};
+
+		// Apply the first count updates, Sherman-Morrison
+		// x = x - w x[p] / (1 + w[p]) for each
+		void apply_updates(
+			std::span<T> result,
+			std::size_t const& count) const
+		{
+			for (std::size_t k{ 0 }; k < count; ++k)
+			{
+				std::span<T const> const w = std::span<T const>(update_vector).subspan(k * n_columns, n_columns);
+				std::size_t const p = update_position[k];
+				T const value = result[p] / (1 + w[p]);
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+					result[i] -= w[i] * value;
+				result[p] = value;
+			}
+		};
+
+		// Compute w of update k and later, from the current source columns.
+		// False if an update makes the matrix (nearly) singular,
+		// or the updates together are too unstable, see max_growth
+		bool compute_updates(
+			std::size_t const& first)
+		{
+			std::vector<T> u(n_rows);
+			for (std::size_t k{ first }; k < update_position.size(); ++k)
+			{
+				std::size_t const column = update_column_index[k];
+				std::span<T const> const original = std::span<T const>(update_original).subspan(k * n_rows, n_rows);
+				for (std::size_t i{ 0 }; i < n_rows; ++i)
+					u[i] = source(i, column) - original[i];
+
+				std::span<T> const w = std::span<T>(update_vector).subspan(k * n_columns, n_columns);
+				if (!substitute(u, w))
+					return false;
+				apply_updates(w, k);
+
+				T const denominator = 1 + w[update_position[k]];
+				if (!std::isfinite(denominator) || (std::abs(denominator) < factor_epsilon))
+					return false;
+			}
+
+			T growth{ 1 };
+			for (std::size_t k{ 0 }; k < update_position.size(); ++k)
+			{
+				std::span<T const> const w = std::span<T const>(update_vector).subspan(k * n_columns, n_columns);
+				T largest{ 1 };
+				for (T const& value : w)
+					largest = std::max<T>(largest, std::abs(value));
+				growth *= largest / std::abs(1 + w[update_position[k]]);
+			}
+
+			return growth <= max_growth;
+		};
+
+	public:
+
+		Factorization() {};
+
+		Factorization(
+			Matrix<T> const& matrix,
+			std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+			Pivot const& pivot = Pivot::Diagonal,
+			Blocking const& blocking = {})
+		{
+			if (!matrix.is_valid())
+				return;
+
+			std::tie(n_rows, n_columns) = matrix.size();
+			source = matrix;
+			factor_epsilon = epsilon;
+			factor_pivot = pivot;
+			factor_blocking = blocking;
+			valid = factor();
+		};
+
+		// True if the factorization succeeded
+		bool is_valid() const
+		{
+			return valid;
+		};
+
+		// Returns number of rows and columns of the factored matrix
+		std::tuple<std::size_t, std::size_t> size() const
+		{
+			return std::tuple(n_rows, n_columns);
+		};
+
+		// Replace a column of the factored matrix. The factorization is corrected
+		// with a rank one update in O(n²) instead of factoring again in O(n³),
+		// unless too many columns have been updated or the update is unstable.
+		// The pivot rows are kept, so the result may differ slightly from a
+		// new factorization. False if data is invalid or the matrix is singular
+		bool update_column(
+			std::size_t const& index,
+			std::vector<T> const& data)
+		{
+			if ((index >= n_columns) || (data.size() != n_rows) || !source.is_valid())
+				return false;
+
+			for (T const& value : data)
+				if (!std::isfinite(value))
+					return false;
+
+			auto const found = std::find(update_column_index.begin(), update_column_index.end(), index);
+			std::size_t const k = found - update_column_index.begin();
+
+			if (found == update_column_index.end())
+			{
+				if (!valid || (k == max_updates))
+				{
+					source.set_column(index, data);
+					valid = factor();
+					return valid;
+				}
+
+				// Position after the column swaps of full pivoting
+				std::size_t position{ index };
+				for (std::size_t i{ 0 }; i < column_swap.size(); ++i)
+					if (position == i)
+						position = column_swap[i];
+					else if (position == column_swap[i])
+						position = i;
+
+				update_column_index.push_back(index);
+				update_position.push_back(position);
+				update_vector.resize(update_vector.size() + n_columns);
+				for (std::size_t i{ 0 }; i < n_rows; ++i)
+					update_original.push_back(source(i, index));
+			}
+
+			source.set_column(index, data);
+			if (!compute_updates(k))
+				valid = factor();
+
+			return valid;
+		};
+
+		// Solve for one right hand side, using caller provided memory.
+		// Result is empty on failure
+		bool solve(
+			std::span<T const> equal,
+			std::vector<T>& result) const
+		{
+			result.clear();
+			if (!valid || (equal.size() != n_rows))
+				return false;
+
+			result.resize(n_columns);
+			if (!substitute(equal, result))
+			{
+				result.clear();
+				return false;
+			}
+			apply_updates(result, update_position.size());
+
+			// Undo the column swaps, in reverse order
+			for (std::size_t i{ column_swap.size() }; i-- > 0;)
+				std::swap(result[i], result[column_swap[i]]);
+
+			return true;
+		};
+
+		// Solve for one right hand side
+		std::vector<T> solve(
+			std::vector<T> const& equal) const
+		{
+			std::vector<T> result;
+			solve(equal, result);
+			return result;
+		};
+
+		// Solve for several right hand sides at once,
+		// each column of equal is one right hand side.
+		// Result has n_columns rows, and is empty on failure
+		Matrix<T> solve(
+			Matrix<T> const& equal) const
+		{
+			auto const [equal_rows, n_equal] = equal.size();
+			if (!valid || (equal_rows != n_rows) || !n_equal)
+				return {};
+
+			Matrix<T> result(n_columns, n_equal);
+
+			// Forward substitution, whole rows at a time
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+			{
+				std::span<T const> const row = lu.row(i);
+				std::span<T> const target = result.row(i);
+				std::span<T const> const from = equal.row(row_order[i]);
+				std::copy(from.begin(), from.end(), target.begin());
+				for (std::size_t j{ 0 }; j < i; ++j)
+					Detail::Axpy<T>(target, std::as_const(result).row(j), row[j]);
+			}
+
+			// Back substitution
+			for (std::size_t i{ n_columns }; i-- > 0;)
+			{
+				std::span<T const> const row = lu.row(i);
+				std::span<T> const target = result.row(i);
+				for (std::size_t j{ i + 1 }; j < n_columns; ++j)
+					Detail::Axpy<T>(target, std::as_const(result).row(j), row[j]);
+				for (T& value : target)
+				{
+					value /= row[i];
+					if (!std::isfinite(value))
+						return {};
+				}
+			}
+
+			// Column updates, applied to whole rows
+			for (std::size_t k{ 0 }; k < update_position.size(); ++k)
+			{
+				std::span<T const> const w = std::span<T const>(update_vector).subspan(k * n_columns, n_columns);
+				std::size_t const p = update_position[k];
+				std::span<T> const target = result.row(p);
+				for (T& value : target)
+					value /= 1 + w[p];
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+					if (i != p)
+						Detail::Axpy<T>(result.row(i), std::as_const(result).row(p), w[i]);
+			}
+
+			// Undo the column swaps, in reverse order
+			for (std::size_t i{ column_swap.size() }; i-- > 0;)
+				std::swap_ranges(result.row(i).begin(), result.row(i).end(), result.row(column_swap[i]).begin());
+
+			return result;
+		};
+
+	};
+
+	// Mixed precision solve, the matrix is factored in the faster type Low
+	// while the residual is computed in T. Correction steps are applied until
+	// the residual (as given by ErrorEstimate) is below tolerance, or stops improving.
+	// Result is empty on failure
+	template<typename Low = double, typename T>
+	std::vector<T> SolveRefined(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		std::type_identity_t<T> const& tolerance = numeric_epsilon_v<T>,
+		std::size_t const& max_steps = 10,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		if (!matrix.is_valid())
+			return {};
+
+		auto const [n_rows, n_columns] = matrix.size();
+
+		if (n_rows != equal.size())
+			return {};
+
+		Factorization<Low> const factorization(Matrix<Low>(matrix), static_cast<Low>(epsilon), pivot);
+		if (!factorization.is_valid())
+			return {};
+
+		std::vector<Low> equal_low(n_rows);
+		std::vector<Low> correction;
+		std::vector<T> result(n_columns);
+		std::vector<T> next(n_columns);
+		std::vector<T> residual(n_rows);
+
+		std::transform(equal.begin(), equal.end(), equal_low.begin(),
+			[](T const& value) { return static_cast<Low>(value); });
+		if (!factorization.solve(equal_low, correction))
+			return {};
+		std::transform(correction.begin(), correction.end(), result.begin(),
+			[](Low const& value) { return static_cast<T>(value); });
+
+		T error = Detail::Residual<T>(matrix, equal, result, residual);
+
+		for (std::size_t step{ 0 }; (step < max_steps) && (error >= tolerance); ++step)
+		{
+			std::transform(residual.begin(), residual.end(), equal_low.begin(),
+				[](T const& value) { return static_cast<Low>(value); });
+			if (!factorization.solve(equal_low, correction))
+				break;
+
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+				next[i] = result[i] + static_cast<T>(correction[i]);
+
+			T const next_error = Detail::Residual<T>(matrix, equal, next, residual);
+			if (!(next_error < error))
+				break;
+
+			std::swap(result, next);
+			error = next_error;
+		}
+
+		return result;
+	};
+
+	// How SolveLeastSquares solves the system
+	enum class LeastSquares : uint8_t
+	{
+		// Householder QR, numerically stable
+		QR,
+		// Cholesky factorization of the normal equations, faster,
+		// but squares the condition number of the matrix
+		NormalEquations
+	};
+
+	// Least squares solution, minimising the squared residual over all rows,
+	// unlike Solve which only uses n_columns of them.
+	// Result is empty on failure, or if the columns are linearly dependent:
+	// with either method, if a diagonal value of R (in A = Q R, or A' A = R' R)
+	// is below epsilon, which is the norm of a column after removing the previous ones
+	template<typename T>
+	std::vector<T> SolveLeastSquares(
+		Matrix<T> const& matrix,
+		std::vector<T> const& equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		LeastSquares const& method = LeastSquares::QR)
+	{
+		if (!matrix.is_valid())
+			return {};
+
+		auto const [n_rows, n_columns] = matrix.size();
+
+		if (n_rows != equal.size())
+			return {};
+
+		std::vector<T> result(n_columns);
+
+		if (method == LeastSquares::NormalEquations)
+		{
+			// Gram matrix and right hand side of the normal equations,
+			// built row by row in a single pass over the matrix
+			Matrix<T> gram(n_columns, n_columns);
+			std::fill(result.begin(), result.end(), T{ 0 });
+			for (std::size_t row{ 0 }; row < n_rows; ++row)
+			{
+				std::span<T const> const source = matrix.row(row);
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+				{
+					Detail::Axpy<T>(gram.row(i).subspan(i), source.subspan(i), -source[i]);
+					result[i] += source[i] * equal[row];
+				}
+			}
+
+			// Cholesky factorization, the upper triangle holds R with gram = R' R.
+			// The diagonal of R is compared with epsilon, as the column norms in QR,
+			// a negative (or NaN) pivot gives NaN and fails as well
+			for (std::size_t k{ 0 }; k < n_columns; ++k)
+			{
+				std::span<T> const pivot_row = gram.row(k);
+				T const diagonal = std::sqrt(pivot_row[k]);
+				if (!(diagonal >= epsilon))
+					return {};
+
+				for (std::size_t j{ k }; j < n_columns; ++j)
+					pivot_row[j] /= diagonal;
+				for (std::size_t i{ k + 1 }; i < n_columns; ++i)
+					Detail::Axpy<T>(gram.row(i).subspan(i), std::as_const(gram).row(k).subspan(i), pivot_row[i]);
+			}
+
+			// Solve R' y = A' b, then R x = y
+			for (std::size_t i{ 0 }; i < n_columns; ++i)
+			{
+				T value = result[i];
+				for (std::size_t j{ 0 }; j < i; ++j)
+					value -= gram.at_unchecked(j, i) * result[j];
+				result[i] = value / gram.at_unchecked(i, i);
+			}
+			for (std::size_t i{ n_columns }; i-- > 0;)
+			{
+				std::span<T const> const row = std::as_const(gram).row(i);
+				T value = result[i];
+				for (std::size_t j{ i + 1 }; j < n_columns; ++j)
+					value -= row[j] * result[j];
+				result[i] = value / row[i];
+				if (!std::isfinite(result[i]))
+					return {};
+			}
+
+			return result;
+		}
+
+		// Householder QR, reflections are applied to the matrix and
+		// right hand side as they are formed, so Q is never stored
+		Matrix<T> qr(matrix);
+		std::vector<T> rhs(equal);
+		std::vector<T> reflector(n_rows);
+		std::vector<T> product(n_columns);
+
+		for (std::size_t k{ 0 }; k < n_columns; ++k)
+		{
+			// Reflector v = x - alpha e, for the column below the diagonal
+			T norm{ 0 };
+			for (std::size_t i{ k }; i < n_rows; ++i)
+			{
+				reflector[i] = qr.at_unchecked(i, k);
+				norm += reflector[i] * reflector[i];
+			}
+			norm = std::sqrt(norm);
+			if (norm < epsilon)
+				return {};
+
+			T const alpha = (reflector[k] > 0) ? -norm : norm;
+			reflector[k] -= alpha;
+			// 2 / v'v
+			T const tau = 1 / (norm * norm - alpha * qr.at_unchecked(k, k));
+
+			// Apply I - tau v v' to the remaining columns and the right hand side
+			std::span<T> const w = std::span<T>(product).subspan(k + 1, n_columns - k - 1);
+			std::fill(w.begin(), w.end(), T{ 0 });
+			T w_rhs{ 0 };
+			for (std::size_t i{ k }; i < n_rows; ++i)
+			{
+				Detail::Axpy<T>(w, std::as_const(qr).row(i).subspan(k + 1), -reflector[i]);
+				w_rhs += reflector[i] * rhs[i];
+			}
+			for (std::size_t i{ k }; i < n_rows; ++i)
+			{
+				Detail::Axpy<T>(qr.row(i).subspan(k + 1), w, tau * reflector[i]);
+				rhs[i] -= tau * reflector[i] * w_rhs;
+			}
+
+			qr.at_unchecked(k, k) = alpha;
+		}
+
+		// Back substitution with R
+		for (std::size_t i{ n_columns }; i-- > 0;)
+		{
+			std::span<T const> const row = std::as_const(qr).row(i);
+			T value = rhs[i];
+			for (std::size_t j{ i + 1 }; j < n_columns; ++j)
+				value -= row[j] * result[j];
+			result[i] = value / row[i];
+			if (!std::isfinite(result[i]))
+				return {};
+		}
+
+		return result;
+	};
+
+	// Solves the Vandermonde system with a column per node,
+	// sum over j of nodes[j]^i * result[j] = equal[i] for i in [0, n),
+	// such as the moment equations of a quadrature rule.
+	// Björck-Pereyra, O(n²) operations on the nodes only, no Matrix is formed.
+	// Result is empty on failure, or if two nodes are equal
+	template<typename T>
+	std::vector<T> SolveVandermonde(
+		std::vector<T> const& nodes,
+		std::vector<std::type_identity_t<T>> const& equal)
+	{
+		std::size_t const n = nodes.size();
+		if (!n || (equal.size() != n))
+			return {};
+
+		// Solve the lower bidiagonal factors, then the upper ones
+		std::vector<T> result(equal);
+		for (std::size_t k{ 0 }; k + 1 < n; ++k)
+			for (std::size_t i{ n - 1 }; i > k; --i)
+				result[i] -= nodes[k] * result[i - 1];
+		for (std::size_t k{ n - 1 }; k-- > 0;)
+		{
+			for (std::size_t i{ k + 1 }; i < n; ++i)
+			{
+				result[i] /= nodes[i] - nodes[i - k - 1];
+				if (!std::isfinite(result[i]))
+					return {};
+			}
+			for (std::size_t i{ k }; i + 1 < n; ++i)
+				result[i] -= result[i + 1];
+		}
+
+		return result;
+	};
+
+	// Solves the Vandermonde system with a row per node,
+	// sum over j of nodes[i]^j * result[j] = equal[i] for i in [0, n),
+	// which gives the coefficients of the interpolating polynomial.
+	// Björck-Pereyra, O(n²) operations. Result is empty on failure, or if two nodes are equal
+	template<typename T>
+	std::vector<T> SolveVandermondeRows(
+		std::vector<T> const& nodes,
+		std::vector<std::type_identity_t<T>> const& equal)
+	{
+		std::size_t const n = nodes.size();
+		if (!n || (equal.size() != n))
+			return {};
+
+		// Newton divided differences, then conversion to the monomial basis
+		std::vector<T> result(equal);
+		for (std::size_t k{ 0 }; k + 1 < n; ++k)
+			for (std::size_t i{ n - 1 }; i > k; --i)
+			{
+				result[i] = (result[i] - result[i - 1]) / (nodes[i] - nodes[i - k - 1]);
+				if (!std::isfinite(result[i]))
+					return {};
+			}
+		for (std::size_t k{ n - 1 }; k-- > 0;)
+			for (std::size_t i{ k }; i + 1 < n; ++i)
+				result[i] -= nodes[k] * result[i + 1];
+
+		return result;
+	};
+
+	// Solves the Cauchy system, sum over j of result[j] / (x[i] - y[j]) = equal[i].
+	// Gaussian elimination with partial pivoting on the generators of the matrix
+	// (Gohberg, Kailath and Olshevsky), O(n²) operations and n² / 2 values of memory.
+	// Result is empty on failure, or if the matrix is singular
+	template<typename T>
+	std::vector<T> SolveCauchy(
+		std::vector<T> x,
+		std::vector<std::type_identity_t<T>> const& y,
+		std::vector<std::type_identity_t<T>> const& equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>)
+	{
+		std::size_t const n = x.size();
+		if (!n || (y.size() != n) || (equal.size() != n))
+			return {};
+
+		// Each Schur complement is Cauchy-like, g[i] h[j] / (x[i] - y[j]),
+		// and elimination only has to update the generators g and h
+		std::vector<T> g(n, T{ 1 });
+		std::vector<T> h(n, T{ 1 });
+		std::vector<T> rhs(equal);
+		std::vector<T> column(n);
+
+		// Rows of U, row k holds n - k values
+		std::vector<T> upper;
+		upper.reserve(n * (n + 1) / 2);
+
+		for (std::size_t k{ 0 }; k < n; ++k)
+		{
+			// Column k of the Schur complement, and its largest magnitude
+			std::size_t pivot_row{ k };
+			T largest{ 0 };
+			for (std::size_t i{ k }; i < n; ++i)
+			{
+				column[i] = g[i] * h[k] / (x[i] - y[k]);
+				if (!std::isfinite(column[i]))
+					return {};
+				if (std::abs(column[i]) > largest)
+				{
+					largest = std::abs(column[i]);
+					pivot_row = i;
+				}
+			}
+
+			// Singular matrix
+			if (largest < epsilon)
+				return {};
+
+			std::swap(x[k], x[pivot_row]);
+			std::swap(g[k], g[pivot_row]);
+			std::swap(rhs[k], rhs[pivot_row]);
+			std::swap(column[k], column[pivot_row]);
+
+			T const diagonal = column[k];
+			upper.push_back(diagonal);
+			for (std::size_t j{ k + 1 }; j < n; ++j)
+				upper.push_back(g[k] * h[j] / (x[k] - y[j]));
+
+			// Forward substitution and generators of the next Schur complement
+			for (std::size_t i{ k + 1 }; i < n; ++i)
+			{
+				rhs[i] -= column[i] / diagonal * rhs[k];
+				g[i] *= (x[i] - x[k]) / (x[i] - y[k]);
+			}
+			for (std::size_t j{ k + 1 }; j < n; ++j)
+				h[j] *= (y[j] - y[k]) / (y[j] - x[k]);
+		}
+
+		// Back substitution with U
+		std::vector<T> result(n);
+		std::size_t offset{ upper.size() };
+		for (std::size_t i{ n }; i-- > 0;)
+		{
+			offset -= n - i;
+			T value = rhs[i];
+			for (std::size_t j{ i + 1 }; j < n; ++j)
+				value -= upper[offset + j - i] * result[j];
+			result[i] = value / upper[offset];
+			if (!std::isfinite(result[i]))
+				return {};
+		}
+
+		return result;
+	};
+
+	// Solves the Toeplitz system, sum over j of diagonal[n - 1 + i - j] * result[j] = equal[i],
+	// diagonal holds the 2n - 1 values from the top right to the bottom left corner.
+	// Levinson-Trench recursion, O(n²) operations and O(n) memory.
+	// It needs all leading square submatrices to be non-singular, it does not pivot.
+	// Result is empty on failure
+	template<typename T>
+	std::vector<T> SolveToeplitz(
+		std::vector<T> const& diagonal,
+		std::vector<std::type_identity_t<T>> const& equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>)
+	{
+		std::size_t const n = equal.size();
+		if (!n || (diagonal.size() != 2 * n - 1))
+			return {};
+
+		// Value of the main diagonal, and of the diagonal offset from it
+		std::size_t const middle{ n - 1 };
+		auto const t = [&](std::ptrdiff_t const offset)
+			{
+				return diagonal[middle + offset];
+			};
+
+		if (std::abs(t(0)) < epsilon)
+			return {};
+
+		std::vector<T> result(n);
+		result[0] = equal[0] / t(0);
+		if (n == 1)
+			return result;
+
+		// Solution of the order m system, and of the two systems
+		// with the previous column and row as right hand side
+		std::vector<T> g(n - 1);
+		std::vector<T> h(n - 1);
+		g[0] = t(-1) / t(0);
+		h[0] = t(1) / t(0);
+
+		for (std::size_t m{ 0 }; m + 1 < n; ++m)
+		{
+			std::size_t const next{ m + 1 };
+
+			T numerator = -equal[next];
+			T denominator = -t(0);
+			for (std::size_t j{ 0 }; j <= m; ++j)
+			{
+				numerator += t(std::ptrdiff_t(next - j)) * result[j];
+				denominator += t(std::ptrdiff_t(next - j)) * g[m - j];
+			}
+			if (std::abs(denominator) < epsilon)
+				return {};
+
+			result[next] = numerator / denominator;
+			for (std::size_t j{ 0 }; j <= m; ++j)
+				result[j] -= result[next] * g[m - j];
+
+			if (next == n - 1)
+				break;
+
+			T g_numerator = -t(-std::ptrdiff_t(next) - 1);
+			T h_numerator = -t(std::ptrdiff_t(next) + 1);
+			T g_denominator = -t(0);
+			for (std::size_t j{ 0 }; j <= m; ++j)
+			{
+				g_numerator += t(std::ptrdiff_t(j) - std::ptrdiff_t(next)) * g[j];
+				h_numerator += t(std::ptrdiff_t(next - j)) * h[j];
+				g_denominator += t(std::ptrdiff_t(j) - std::ptrdiff_t(next)) * h[m - j];
+			}
+			if (std::abs(g_denominator) < epsilon)
+				return {};
+
+			g[next] = g_numerator / g_denominator;
+			h[next] = h_numerator / denominator;
+
+			// Update both from the ends towards the middle
+			T const g_next = g[next];
+			T const h_next = h[next];
+			for (std::size_t j{ 0 }, k{ m }; j < (m + 2) / 2; ++j, --k)
+			{
+				T const g_j = g[j];
+				T const g_k = g[k];
+				T const h_j = h[j];
+				T const h_k = h[k];
+				g[j] = g_j - g_next * h_k;
+				g[k] = g_k - g_next * h_j;
+				h[j] = h_j - h_next * g_k;
+				h[k] = h_k - h_next * g_j;
+			}
+		}
+
+		for (T const& value : result)
+			if (!std::isfinite(value))
+				return {};
 
 		return result;
 	};
 
-	// For a square matrix this should be zero.
-	// An overdetermined matrix has more equations than unknowns,
-	// so the result may not be correct for all of them
-	// TODO Mathness: does this have a proper name?
-	Real ErrorEstimate(
-		Matrix const& matrix,
-		std::vector<Real> const& equal,
-		std::vector<Real> const& result)
+	// Result of Minimize
+	template<typename T = Real>
+	struct Minimum final
+	{
+		T parameter{ NaN_v<T> };
+		T value{ NaN_v<T> };
+		std::size_t evaluations{ 0 };
+	};
+
+	// Brent's method for a minimum of function(parameter) in [lower, upper],
+	// golden section steps with parabolic interpolation where that is safe.
+	// Needs far fewer evaluations than a grid search. Values that are not finite
+	// are taken as larger than any other, the function should be unimodal
+	template<typename T, typename Function>
+	Minimum<T> Minimize(
+		Function&& function,
+		T lower,
+		T upper,
+		std::type_identity_t<T> const& tolerance = numeric_epsilon_v<T>,
+		std::size_t const& max_evaluations = 200)
+	{
+		Minimum<T> minimum;
+		if (!(lower < upper))
+			return minimum;
+
+		auto const evaluate = [&](T const& parameter)
+			{
+				++minimum.evaluations;
+				T const value = function(parameter);
+				return std::isfinite(value) ? value : std::numeric_limits<T>::infinity();
+			};
+
+		// Golden section ratio, (3 - sqrt(5)) / 2
+		T const golden = (3 - std::sqrt(T{ 5 })) / 2;
+
+		T x = lower + golden * (upper - lower);
+		T w{ x };
+		T v{ x };
+		T fx = evaluate(x);
+		T fw{ fx };
+		T fv{ fx };
+		T d{ 0 };
+		T e{ 0 };
+
+		while (minimum.evaluations < max_evaluations)
+		{
+			T const middle = (lower + upper) / 2;
+			T const tol = numeric_epsilon_v<T> * std::abs(x) + tolerance / 3;
+			T const tol2 = 2 * tol;
+
+			if (std::abs(x - middle) <= tol2 - (upper - lower) / 2)
+				break;
+
+			bool golden_step{ true };
+			if (std::abs(e) > tol)
+			{
+				// Parabola through x, w and v
+				T r = (x - w) * (fx - fv);
+				T q = (x - v) * (fx - fw);
+				T p = (x - v) * q - (x - w) * r;
+				q = 2 * (q - r);
+				if (q > 0)
+					p = -p;
+				else
+					q = -q;
+				r = e;
+				e = d;
+
+				if ((std::abs(p) < std::abs(q * r / 2)) && (p > q * (lower - x)) && (p < q * (upper - x)))
+				{
+					d = p / q;
+					T const u = x + d;
+					if (((u - lower) < tol2) || ((upper - u) < tol2))
+						d = (x < middle) ? tol : -tol;
+					golden_step = false;
+				}
+			}
+			if (golden_step)
+			{
+				e = ((x < middle) ? upper : lower) - x;
+				d = golden * e;
+			}
+
+			T const u = x + ((std::abs(d) >= tol) ? d : ((d > 0) ? tol : -tol));
+			T const fu = evaluate(u);
+
+			if (fu <= fx)
+			{
+				if (u < x)
+					upper = x;
+				else
+					lower = x;
+				v = w;
+				fv = fw;
+				w = x;
+				fw = fx;
+				x = u;
+				fx = fu;
+			}
+			else
+			{
+				if (u < x)
+					lower = u;
+				else
+					upper = u;
+				if ((fu <= fw) || (w == x))
+				{
+					v = w;
+					fv = fw;
+					w = u;
+					fw = fu;
+				}
+				else if ((fu <= fv) || (v == x) || (v == w))
+				{
+					v = u;
+					fv = fu;
+				}
+			}
+		}
+
+		minimum.parameter = x;
+		minimum.value = fx;
+		return minimum;
+	};
+
+	// Parallel search for a minimum of function(parameter, thread) in [lower, upper].
+	// Each round evaluates probes evenly spaced points at once, and continues
+	// between the neighbours of the best one, so the interval shrinks by
+	// (probes + 1) / 2 per round. thread is as for ThreadPool::parallel_for,
+	// so the function can keep state (such as a ColumnError) per thread
+	template<typename T, typename Function>
+	Minimum<T> Minimize(
+		ThreadPool& pool,
+		Function&& function,
+		T lower,
+		T upper,
+		std::type_identity_t<T> const& tolerance = numeric_epsilon_v<T>,
+		std::size_t const& probes = 7,
+		std::size_t const& max_rounds = 100)
+	{
+		Minimum<T> minimum;
+		if (!(lower < upper) || !probes)
+			return minimum;
+
+		std::vector<T> parameter(probes);
+		std::vector<T> value(probes);
+
+		for (std::size_t round{ 0 }; round < max_rounds; ++round)
+		{
+			T const h = (upper - lower) / (probes + 1);
+			for (std::size_t i{ 0 }; i < probes; ++i)
+				parameter[i] = lower + h * (i + 1);
+
+			pool.parallel_for(probes, [&](std::size_t const& begin, std::size_t const& end, std::size_t const& thread)
+				{
+					for (std::size_t i{ begin }; i < end; ++i)
+					{
+						value[i] = function(std::as_const(parameter[i]), thread);
+						if (!std::isfinite(value[i]))
+							value[i] = std::numeric_limits<T>::infinity();
+					}
+				}, 1);
+			minimum.evaluations += probes;
+
+			std::size_t const best = std::min_element(value.begin(), value.end()) - value.begin();
+			if (!(value[best] > minimum.value))
+			{
+				minimum.parameter = parameter[best];
+				minimum.value = value[best];
+			}
+
+			T const next_lower = best ? parameter[best - 1] : lower;
+			T const next_upper = (best + 1 < probes) ? parameter[best + 1] : upper;
+			if (!(next_upper - next_lower > tolerance) || !(next_lower < next_upper))
+				break;
+
+			lower = next_lower;
+			upper = next_upper;
+		}
+
+		return minimum;
+	};
+
+	// ErrorEstimate of the solution, as a function of a parameter that only
+	// changes one column of the matrix. Warm starts from the factorization
+	// of the previous call, which is updated in O(n²) rather than redone.
+	// column(parameter, data) fills the values of the column
+	template<typename T, typename Column>
+	class ColumnError final
+	{
+
+	private:
+
+		Matrix<T> matrix{};
+		std::vector<T> equal{};
+		std::size_t index{ 0 };
+		Column column;
+
+		Factorization<T> factorization{};
+
+		std::vector<T> data{};
+		std::vector<T> result{};
+
+	public:
+
+		ColumnError(
+			Matrix<T> const& matrix,
+			std::vector<T> const& equal,
+			std::size_t const& index,
+			Column column,
+			std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+			Pivot const& pivot = Pivot::Diagonal)
+			: matrix(matrix), equal(equal), index(index), column(std::move(column)),
+			factorization(matrix, epsilon, pivot)
+		{
+			data.resize(std::get<0>(matrix.size()));
+		};
+
+		// NaN if the matrix has no solution for parameter
+		T operator () (
+			T const& parameter)
+		{
+			column(parameter, data);
+			matrix.set_column(index, data);
+			if (!factorization.update_column(index, data))
+				return NaN_v<T>;
+
+			if (!factorization.solve(equal, result))
+				return NaN_v<T>;
+
+			return ErrorEstimate(matrix, equal, result);
+		};
+
+	};
+
+	// Sparse matrix, in compressed column form.
+	// Only square or overdetermined matrices can be solved
+	template<typename T = Real>
+	class SparseMatrix final
+	{
+
+	public:
+
+		// One non-zero cell
+		struct Entry
+		{
+			std::size_t row{ 0 };
+			std::size_t column{ 0 };
+			T value{ 0 };
+		};
+
+	private:
+
+		std::size_t n_rows{ 0 };
+		std::size_t n_columns{ 0 };
+
+		// Cells of a column are at [column_start[column], column_start[column + 1]),
+		// sorted by row
+		std::vector<std::size_t> column_start{};
+		std::vector<std::size_t> row_index{};
+		std::vector<T> cell{};
+
+	public:
+
+		SparseMatrix() {};
+
+		// Duplicate entries are summed. The matrix is left empty
+		// if any entry is out of range or not finite
+		SparseMatrix(
+			std::size_t const& rows,
+			std::size_t const& columns,
+			std::vector<Entry> entries)
+		{
+			for (Entry const& entry : entries)
+				if ((entry.row >= rows) || (entry.column >= columns) || !std::isfinite(entry.value))
+					return;
+
+			std::sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b)
+				{
+					return (a.column < b.column) || ((a.column == b.column) && (a.row < b.row));
+				});
+
+			column_start.assign(columns + 1, 0);
+			row_index.reserve(entries.size());
+			cell.reserve(entries.size());
+			for (std::size_t i{ 0 }; i < entries.size(); ++i)
+			{
+				Entry const& entry = entries[i];
+				if (i && (entry.column == entries[i - 1].column) && (entry.row == entries[i - 1].row))
+				{
+					cell.back() += entry.value;
+					continue;
+				}
+
+				row_index.push_back(entry.row);
+				cell.push_back(entry.value);
+				++column_start[entry.column + 1];
+			}
+			for (std::size_t i{ 0 }; i < columns; ++i)
+				column_start[i + 1] += column_start[i];
+
+			n_rows = rows;
+			n_columns = columns;
+		};
+
+		// Non-zero cells of a dense matrix
+		explicit SparseMatrix(
+			Matrix<T> const& matrix)
+		{
+			std::tie(n_rows, n_columns) = matrix.size();
+
+			column_start.assign(n_columns + 1, 0);
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+			{
+				for (std::size_t row{ 0 }; row < n_rows; ++row)
+					if (matrix.at_unchecked(row, column) != 0)
+					{
+						row_index.push_back(row);
+						cell.push_back(matrix.at_unchecked(row, column));
+					}
+				column_start[column + 1] = row_index.size();
+			}
+		};
+
+		// Get the value at [row,column]
+		T operator () (
+			std::size_t const& row,
+			std::size_t const& column) const
+		{
+			if ((row >= n_rows) || (column >= n_columns))
+				return NaN_v<T>;
+
+			std::span<std::size_t const> const index = rows(column);
+			auto const found = std::lower_bound(index.begin(), index.end(), row);
+			if ((found == index.end()) || (*found != row))
+				return 0;
+
+			return cell[column_start[column] + (found - index.begin())];
+		};
+
+		// Rows of the non-zero cells in a column
+		std::span<std::size_t const> rows(
+			std::size_t const& column) const
+		{
+			if (column >= n_columns)
+				return {};
+
+			return std::span<std::size_t const>(row_index).subspan(column_start[column], column_start[column + 1] - column_start[column]);
+		};
+
+		// Values of the non-zero cells in a column
+		std::span<T const> values(
+			std::size_t const& column) const
+		{
+			if (column >= n_columns)
+				return {};
+
+			return std::span<T const>(cell).subspan(column_start[column], column_start[column + 1] - column_start[column]);
+		};
+
+		// Returns number of rows and columns
+		std::tuple<std::size_t, std::size_t> size() const
+		{
+			return std::tuple(n_rows, n_columns);
+		};
+
+		// Number of stored cells
+		std::size_t non_zeros() const
+		{
+			return cell.size();
+		};
+
+		// True if the matrix is square or overdetermined,
+		// and neither number of rows or columns are zero
+		bool is_valid() const
+		{
+			if (!n_rows || !n_columns || (n_rows < n_columns))
+				return false;
+
+			return true;
+		};
+
+	};
+
+	// Column order used by the sparse factorization
+	enum class Ordering : uint8_t
+	{
+		// Columns as given
+		Natural,
+		// Minimum degree on the pattern of A'A, to reduce fill-in
+		MinimumDegree
+	};
+
+	namespace Detail
+	{
+
+		// Minimum degree ordering of the columns, on the graph of A'A.
+		// Two columns are connected if they share a row,
+		// eliminating a column connects all its neighbours
+		template<typename T>
+		std::vector<std::size_t> MinimumDegreeOrder(
+			SparseMatrix<T> const& matrix)
+		{
+			auto const [n_rows, n_columns] = matrix.size();
+
+			// Columns of each row
+			std::vector<std::vector<std::size_t>> row_columns(n_rows);
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+				for (std::size_t const& row : matrix.rows(column))
+					row_columns[row].push_back(column);
+
+			std::size_t constexpr unmarked = std::numeric_limits<std::size_t>::max();
+			std::vector<std::size_t> mark(n_columns, unmarked);
+
+			std::vector<std::vector<std::size_t>> adjacent(n_columns);
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+			{
+				mark[column] = column;
+				for (std::size_t const& row : matrix.rows(column))
+					for (std::size_t const& other : row_columns[row])
+						if (mark[other] != column)
+						{
+							mark[other] = column;
+							adjacent[column].push_back(other);
+						}
+			}
+
+			std::set<std::pair<std::size_t, std::size_t>> queue;
+			for (std::size_t column{ 0 }; column < n_columns; ++column)
+				queue.emplace(adjacent[column].size(), column);
+
+			std::vector<bool> eliminated(n_columns, false);
+			std::vector<std::size_t> order;
+			order.reserve(n_columns);
+			std::fill(mark.begin(), mark.end(), unmarked);
+			std::vector<std::size_t> merged;
+			std::size_t stamp{ 0 };
+
+			while (!queue.empty())
+			{
+				std::size_t const column = queue.begin()->second;
+				queue.erase(queue.begin());
+				eliminated[column] = true;
+				order.push_back(column);
+
+				// Remaining neighbours become a clique
+				std::vector<std::size_t>& neighbours = adjacent[column];
+				std::erase_if(neighbours, [&](std::size_t const& other) { return eliminated[other]; });
+				for (std::size_t const& other : neighbours)
+				{
+					std::vector<std::size_t>& list = adjacent[other];
+					queue.erase({ list.size(), other });
+
+					merged.clear();
+					mark[other] = ++stamp;
+					for (std::size_t const& next : list)
+						if (!eliminated[next] && (mark[next] != stamp))
+						{
+							mark[next] = stamp;
+							merged.push_back(next);
+						}
+					for (std::size_t const& next : neighbours)
+						if (mark[next] != stamp)
+						{
+							mark[next] = stamp;
+							merged.push_back(next);
+						}
+					list.swap(merged);
+
+					queue.emplace(list.size(), other);
+				}
+				neighbours.clear();
+			}
+
+			return order;
+		};
+
+	};
+
+	// Sparse LU factorization, left-looking with threshold partial pivoting (Gilbert-Peierls).
+	// Each column is found by a sparse triangular solve, so the work scales
+	// with the number of non-zeros in the factors rather than the matrix size.
+	// For overdetermined matrices the pivot rows are chosen among all rows
+	template<typename T = Real>
+	class SparseFactorization final
+	{
+
+	private:
+
+		static std::size_t constexpr none{ std::numeric_limits<std::size_t>::max() };
+
+		// Fraction of the largest candidate the diagonal must reach to be the pivot
+		static constexpr double diagonal_threshold{ 0.1 };
+
+		std::size_t n_rows{ 0 };
+		std::size_t n_columns{ 0 };
+
+		// Original column of each elimination step
+		std::vector<std::size_t> column_order{};
+
+		// Pivot row of each elimination step
+		std::vector<std::size_t> pivot_row{};
+
+		// L by columns with original row indices, the unit diagonal is not stored
+		std::vector<std::size_t> l_start{};
+		std::vector<std::size_t> l_row{};
+		std::vector<T> l_value{};
+
+		// U by columns with step indices, the diagonal is stored last in each column
+		std::vector<std::size_t> u_start{};
+		std::vector<std::size_t> u_row{};
+		std::vector<T> u_value{};
+
+		bool valid{ false };
+
+		bool factor(
+			SparseMatrix<T> const& matrix,
+			T const& epsilon)
+		{
+			// Elimination step of each row, none if not yet used as pivot
+			std::vector<std::size_t> step(n_rows, none);
+
+			// Dense work column, and pattern of its non-zeros in topological order
+			std::vector<T> x(n_rows, 0);
+			std::vector<std::size_t> pattern(n_rows);
+			std::vector<std::size_t> mark(n_rows, none);
+			std::vector<std::pair<std::size_t, std::size_t>> stack;
+
+			pivot_row.resize(n_columns);
+			l_start.assign(1, 0);
+			u_start.assign(1, 0);
+
+			for (std::size_t k{ 0 }; k < n_columns; ++k)
+			{
+				std::span<std::size_t const> const rows = matrix.rows(column_order[k]);
+				std::span<T const> const values = matrix.values(column_order[k]);
+
+				// Rows reachable in the graph of L from the non-zeros of the column,
+				// depth first so that each row comes after the rows it depends on
+				std::size_t top{ n_rows };
+				for (std::size_t const& start : rows)
+				{
+					if (mark[start] == k)
+						continue;
+
+					mark[start] = k;
+					stack.emplace_back(start, 0);
+					while (!stack.empty())
+					{
+						auto& [row, next] = stack.back();
+						std::size_t const column = step[row];
+						bool descended{ false };
+						if (column != none)
+							for (std::size_t end = l_start[column + 1]; l_start[column] + next < end; ++next)
+							{
+								std::size_t const child = l_row[l_start[column] + next];
+								if (mark[child] != k)
+								{
+									mark[child] = k;
+									++next;
+									stack.emplace_back(child, 0);
+									descended = true;
+									break;
+								}
+							}
+
+						if (!descended)
+						{
+							pattern[--top] = stack.back().first;
+							stack.pop_back();
+						}
+					}
+				}
+
+				// Sparse triangular solve, L x = column
+				for (std::size_t p{ top }; p < n_rows; ++p)
+					x[pattern[p]] = 0;
+				for (std::size_t i{ 0 }; i < rows.size(); ++i)
+					x[rows[i]] = values[i];
+				for (std::size_t p{ top }; p < n_rows; ++p)
+				{
+					std::size_t const row = pattern[p];
+					std::size_t const column = step[row];
+					if (column == none)
+						continue;
+
+					for (std::size_t q{ l_start[column] }; q < l_start[column + 1]; ++q)
+						x[l_row[q]] -= l_value[q] * x[row];
+				}
+
+				// Rows already used give U, the largest remaining one is the pivot
+				std::size_t pivot{ none };
+				T largest{ 0 };
+				for (std::size_t p{ top }; p < n_rows; ++p)
+				{
+					std::size_t const row = pattern[p];
+					if (step[row] != none)
+					{
+						u_row.push_back(step[row]);
+						u_value.push_back(x[row]);
+					}
+					else if (std::abs(x[row]) > largest)
+					{
+						largest = std::abs(x[row]);
+						pivot = row;
+					}
+				}
+
+				// Singular matrix
+				if ((pivot == none) || (largest < epsilon) || !std::isfinite(largest))
+					return false;
+
+				// Prefer the diagonal when it is not much smaller, that keeps
+				// the pattern the column ordering was made for
+				std::size_t const preferred = column_order[k];
+				if ((mark[preferred] == k) && (step[preferred] == none) && (std::abs(x[preferred]) >= diagonal_threshold * largest))
+					pivot = preferred;
+
+				T const diagonal = x[pivot];
+				u_row.push_back(k);
+				u_value.push_back(diagonal);
+				u_start.push_back(u_row.size());
+
+				step[pivot] = k;
+				pivot_row[k] = pivot;
+				for (std::size_t p{ top }; p < n_rows; ++p)
+				{
+					std::size_t const row = pattern[p];
+					if (step[row] == none)
+					{
+						l_row.push_back(row);
+						l_value.push_back(x[row] / diagonal);
+					}
+				}
+				l_start.push_back(l_row.size());
+			}
+
+			return true;
+		};
+
+	public:
+
+		SparseFactorization() {};
+
+		SparseFactorization(
+			SparseMatrix<T> const& matrix,
+			std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+			Ordering const& ordering = Ordering::MinimumDegree)
+		{
+			if (!matrix.is_valid())
+				return;
+
+			std::tie(n_rows, n_columns) = matrix.size();
+
+			if (ordering == Ordering::MinimumDegree)
+				column_order = Detail::MinimumDegreeOrder(matrix);
+			else
+			{
+				column_order.resize(n_columns);
+				for (std::size_t i{ 0 }; i < n_columns; ++i)
+					column_order[i] = i;
+			}
+
+			valid = factor(matrix, epsilon);
+		};
+
+		// True if the factorization succeeded
+		bool is_valid() const
+		{
+			return valid;
+		};
+
+		// Returns number of rows and columns of the factored matrix
+		std::tuple<std::size_t, std::size_t> size() const
+		{
+			return std::tuple(n_rows, n_columns);
+		};
+
+		// Number of stored cells in L and U
+		std::size_t non_zeros() const
+		{
+			return l_value.size() + u_value.size();
+		};
+
+		// Solve for one right hand side, using caller provided memory.
+		// Result is empty on failure
+		bool solve(
+			std::span<T const> equal,
+			std::vector<T>& result) const
+		{
+			result.clear();
+			if (!valid || (equal.size() != n_rows))
+				return false;
+
+			// Forward substitution, rows are updated as each step is solved
+			std::vector<T> x(equal.begin(), equal.end());
+			std::vector<T> y(n_columns);
+			for (std::size_t k{ 0 }; k < n_columns; ++k)
+			{
+				y[k] = x[pivot_row[k]];
+				for (std::size_t q{ l_start[k] }; q < l_start[k + 1]; ++q)
+					x[l_row[q]] -= l_value[q] * y[k];
+			}
+
+			// Back substitution, by columns of U
+			for (std::size_t k{ n_columns }; k-- > 0;)
+			{
+				std::size_t const last = u_start[k + 1] - 1;
+				y[k] /= u_value[last];
+				if (!std::isfinite(y[k]))
+					return false;
+
+				for (std::size_t q{ u_start[k] }; q < last; ++q)
+					y[u_row[q]] -= u_value[q] * y[k];
+			}
+
+			result.resize(n_columns);
+			for (std::size_t k{ 0 }; k < n_columns; ++k)
+				result[column_order[k]] = y[k];
+
+			return true;
+		};
+
+		// Solve for one right hand side
+		std::vector<T> solve(
+			std::vector<T> const& equal) const
+		{
+			std::vector<T> result;
+			solve(equal, result);
+			return result;
+		};
+
+	};
+
+	// Sparse LU elimination, memory and time scale with the non-zeros.
+	// Result is empty on failure
+	template<typename T>
+	std::vector<T> Solve(
+		SparseMatrix<T> const& matrix,
+		std::vector<T> const& equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Ordering const& ordering = Ordering::MinimumDegree)
+	{
+		return SparseFactorization<T>(matrix, epsilon, ordering).solve(equal);
+	};
+
+	// Same as ErrorEstimate for Matrix
+	template<typename T>
+	T ErrorEstimate(
+		SparseMatrix<T> const& matrix,
+		std::vector<T> const& equal,
+		std::vector<T> const& result)
 	{
 		if (!matrix.is_valid())
-			return NaN;
+			return NaN_v<T>;
 
 		auto const [n_rows, n_columns] = matrix.size();
 
 		if ((n_rows != equal.size()) || (n_columns != result.size()))
-			return NaN;
+			return NaN_v<T>;
+
+		std::vector<T> sum(n_rows, 0);
+		for (std::size_t j{ 0 }; j < n_columns; ++j)
+		{
+			std::span<std::size_t const> const rows = matrix.rows(j);
+			std::span<T const> const values = matrix.values(j);
+			for (std::size_t i{ 0 }; i < rows.size(); ++i)
+				sum[rows[i]] += values[i] * result[j];
+		}
+
+		T error{ 0 };
+		for (std::size_t i{ 0 }; i < n_rows; ++i)
+			error += std::abs(sum[i] - equal[i]);
+
+		return error;
+	};
+
+	// Matrix with a size known at compile time, for small systems.
+	// Cells are stored row-major in a std::array, there is no heap allocation
+	// and no range check; row and column must be in range
+	template<std::size_t R, std::size_t C, typename T = Real>
+	class FixedMatrix final
+	{
+
+		static_assert((R >= C) && (C > 0), "Only square or overdetermined matrices are supported");
+
+	private:
+
+		std::array<T, R * C> cell{};
+
+	public:
+
+		constexpr FixedMatrix() {};
+
+		// Cells in row-major order
+		constexpr FixedMatrix(
+			std::array<T, R * C> const& cells)
+			: cell(cells)
+		{};
+
+		// Read/Write the value at [row,column]
+		constexpr T& operator () (
+			std::size_t const& row,
+			std::size_t const& column)
+		{
+			return cell[row * C + column];
+		};
+
+		// Get the value at [row,column]
+		constexpr T operator () (
+			std::size_t const& row,
+			std::size_t const& column) const
+		{
+			return cell[row * C + column];
+		};
+
+		constexpr void set_row(
+			std::size_t const& index,
+			std::array<T, C> const& data)
+		{
+			for (std::size_t i{ 0 }; i < C; ++i)
+				if (!Detail::IsFinite(data[i]))
+					return;
+
+			for (std::size_t i{ 0 }; i < C; ++i)
+				cell[index * C + i] = data[i];
+		};
+
+		constexpr void set_column(
+			std::size_t const& index,
+			std::array<T, R> const& data)
+		{
+			for (std::size_t i{ 0 }; i < R; ++i)
+				if (!Detail::IsFinite(data[i]))
+					return;
+
+			for (std::size_t i{ 0 }; i < R; ++i)
+				cell[i * C + index] = data[i];
+		};
+
+		// Returns number of rows and columns
+		static constexpr std::tuple<std::size_t, std::size_t> size()
+		{
+			return std::tuple(R, C);
+		};
+
+		// Tests diagonal for zeroes
+		constexpr bool is_diagonal_nonzero(
+			T const& epsilon = magnitude_zero_v<T>) const
+		{
+			for (std::size_t i{ 0 }; i < C; ++i)
+				if (Detail::Abs(cell[i * C + i]) < epsilon)
+					return false;
+
+			return true;
+		};
+
+	};
+
+	namespace Detail
+	{
+
+		// Same search as for Matrix, with storage on the stack
+		template<std::size_t R, std::size_t C, typename T>
+		constexpr bool ReorderDiagonal(
+			FixedMatrix<R, C, T>& matrix,
+			std::array<T, R>& equal,
+			T const& epsilon)
+		{
+			// The non-zero entries for each column,
+			// nze_count[column] rows are stored from nze_list[column * R]
+			std::array<std::size_t, R * C> nze_list{};
+			std::array<std::size_t, C> nze_count{};
+			for (std::size_t column{ 0 }; column < C; ++column)
+			{
+				for (std::size_t row{ 0 }; row < R; ++row)
+					if (Abs(matrix(row, column)) >= epsilon)
+						nze_list[column * R + nze_count[column]++] = row;
+				// Column has only zeroes
+				if (!nze_count[column])
+					return false;
+			}
+
+			std::array<std::size_t, C> diagonal{};
+			std::array<std::size_t, R> row_column{};
+			std::array<std::size_t, C> list_index{};
+			std::array<std::size_t, C> path{};
+			std::array<std::size_t, R> visit{};
+			std::size_t searches{ 0 };
+			if (!MatchDiagonal(nze_list, nze_count, R, diagonal, row_column, list_index, path, visit, searches))
+				return false;
+
+			// Swap the chosen rows into place
+			std::array<std::size_t, R> position{};
+			std::array<std::size_t, R> origin{};
+			for (std::size_t i{ 0 }; i < R; ++i)
+				position[i] = origin[i] = i;
+			for (std::size_t row{ 0 }; row < C; ++row)
+			{
+				std::size_t const index = position[diagonal[row]];
+				if (index == row)
+					continue;
+
+				for (std::size_t k{ 0 }; k < C; ++k)
+					std::swap(matrix(row, k), matrix(index, k));
+				std::swap(equal[row], equal[index]);
+				std::swap(origin[row], origin[index]);
+				position[origin[row]] = row;
+				position[origin[index]] = index;
+			}
+
+			return true;
+		};
+
+	};
+
+	// Gauss Jordan elimination of a fixed size system, same method as for Matrix.
+	// Usable in constant evaluation, result is empty on failure
+	template<std::size_t R, std::size_t C, typename T>
+	constexpr std::optional<std::array<T, C>> Solve(
+		FixedMatrix<R, C, T> matrix,
+		std::array<T, R> equal,
+		std::type_identity_t<T> const& epsilon = magnitude_zero_v<T>,
+		Pivot const& pivot = Pivot::Diagonal)
+	{
+		// Method uses the diagonal, so it must be non-zero
+		if ((pivot == Pivot::Diagonal) && !matrix.is_diagonal_nonzero(epsilon))
+			if (!Detail::ReorderDiagonal(matrix, equal, epsilon))
+				return std::nullopt;
+
+		// Rows that are updated, the extra rows of an overdetermined matrix
+		// are only needed if they can still become a pivot row
+		std::size_t const n_active = (pivot == Pivot::Diagonal) ? C : R;
+
+		std::array<std::size_t, C> column_order{};
+		for (std::size_t i{ 0 }; i < C; ++i)
+			column_order[i] = i;
+
+		for (std::size_t column{ 0 }; column < C; ++column)
+		{
+			if (pivot != Pivot::Diagonal)
+			{
+				// Search largest magnitude among remaining rows (and columns)
+				std::size_t const last_column = (pivot == Pivot::Full) ? C : column + 1;
+				std::size_t pivot_row{ column };
+				std::size_t pivot_column{ column };
+				T largest{ 0 };
+				for (std::size_t row{ column }; row < R; ++row)
+					for (std::size_t k{ column }; k < last_column; ++k)
+						if (Detail::Abs(matrix(row, k)) > largest)
+						{
+							largest = Detail::Abs(matrix(row, k));
+							pivot_row = row;
+							pivot_column = k;
+						}
+
+				// Singular matrix
+				if (largest < epsilon)
+					return std::nullopt;
+
+				if (pivot_row != column)
+				{
+					for (std::size_t k{ 0 }; k < C; ++k)
+						std::swap(matrix(column, k), matrix(pivot_row, k));
+					std::swap(equal[column], equal[pivot_row]);
+				}
+				if (pivot_column != column)
+				{
+					for (std::size_t row{ 0 }; row < R; ++row)
+						std::swap(matrix(row, column), matrix(row, pivot_column));
+					std::swap(column_order[column], column_order[pivot_column]);
+				}
+			}
+
+			// A zero divisor is checked first, as it can not be evaluated at compile time
+			if (matrix(column, column) == T{ 0 })
+				return std::nullopt;
+
+			for (std::size_t row{ 0 }; row < n_active; ++row)
+				if (row != column)
+				{
+					T const scalar = matrix(row, column) / matrix(column, column);
+					if (!Detail::IsFinite(scalar))
+						return std::nullopt;
+
+					for (std::size_t k{ 0 }; k < C; ++k)
+						matrix(row, k) -= matrix(column, k) * scalar;
+
+					equal[row] -= equal[column] * scalar;
+				}
+		}
+
+		// Rescale diagonal to 1, to get result
+		std::array<T, C> result{};
+		for (std::size_t i{ 0 }; i < C; ++i)
+		{
+			if (matrix(i, i) == T{ 0 })
+				return std::nullopt;
 
-		Real error{ 0 };
-		for (uint16_t i{ 0 }; i < n_rows; ++i)
+			T const value = equal[i] / matrix(i, i);
+			if (!Detail::IsFinite(value))
+				return std::nullopt;
+
+			result[column_order[i]] = value;
+		}
+
+		return result;
+	};
+
+	// Same as ErrorEstimate for Matrix
+	template<std::size_t R, std::size_t C, typename T>
+	constexpr T ErrorEstimate(
+		FixedMatrix<R, C, T> const& matrix,
+		std::array<T, R> const& equal,
+		std::array<T, C> const& result)
+	{
+		T error{ 0 };
+		for (std::size_t i{ 0 }; i < R; ++i)
 		{
-			Real sum{ 0 };
-			for (uint16_t j{ 0 };j < n_columns;++j)
+			T sum{ 0 };
+			for (std::size_t j{ 0 }; j < C; ++j)
 				sum += matrix(i, j) * result[j];
 
-			error += std::abs(sum - equal[i]);
+			error += Detail::Abs(sum - equal[i]);
 		}
 
 		return error;
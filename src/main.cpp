@@ -19,11 +19,18 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <string_view>
 
 #include "./gauss_jordan.hpp"
 
-int main()
+// With --binary the sweep is also written to plot_data.bin,
+// and plot_data.txt is converted from that file
+int main(
+	int argc,
+	char* argv[])
 {
+	bool const binary = (argc > 1) && (std::string_view(argv[1]) == "--binary");
+
 	// Set up equations to solve for Kronrod extension of Gauss Lobatto quadrature
 	std::vector<Real> equal{ 2.q, 2.q / 3.q, 2.q / 5.q, 2.q / 7.q, 2.q / 9.q };
 
@@ -38,50 +45,58 @@ int main()
 	std::cout << std::setprecision(10);
 	if (file.is_open())
 	{
+		std::vector<Real> parameters(500);
 		for (uint16_t i{ 0 }; i < 500; ++i)
-		{
-			x = 0.002q * i;
-			matrix.set_column(2, { 2, 2 * x, 2 * x * x, 2 * x * x * x, 2 * x * x * x * x });
+			parameters[i] = 0.002q * i;
 
-			auto result = GaussJordan::Solve(matrix, equal);
+		// Same text as file << value, which formats float128 with RealToString
+		// at the std::cout precision, and other types at the file's own precision
+#if __STDCPP_FLOAT128_T__ == 1
+		int const precision = static_cast<int>(std::cout.precision());
+		bool const space_sign{ true };
+#else
+		int const precision = static_cast<int>(file.precision());
+		bool const space_sign{ false };
+#endif
 
-			Real y = GaussJordan::ErrorEstimate(matrix, equal, result);
+		GaussJordan::ThreadPool pool;
+		auto const points = GaussJordan::Sweep(pool, matrix, equal,
+			[](Real const& t, GaussJordan::Matrix<Real>& system, std::vector<Real>&)
+			{
+				system.set_column(2, { 2, 2 * t, 2 * t * t, 2 * t * t * t, 2 * t * t * t * t });
+			}, parameters);
 
-			if (std::isfinite(y))
-				file << x << "  " << y << "\n";
+		if (binary)
+		{
+			{
+				std::ofstream binary_file("plot_data.bin", std::ios::out | std::ios::binary);
+				GaussJordan::WriteSweep(binary_file, points);
+			}
+			GaussJordan::MappedFile const mapped("plot_data.bin");
+			GaussJordan::SweepToText(GaussJordan::SweepView<Real>(mapped.data()), file, precision, space_sign);
+		}
+		else
+		{
+			GaussJordan::Writer writer(file, precision, 1 << 16, space_sign);
+			for (auto const& point : points)
+				if (std::isfinite(point.error))
+					writer << point.parameter << "  " << point.error << '\n';
 		}
 		file.close();
 
 		std::system("gnuplot plot_config.txt");
 	}
 
-	// Bracket search for minimal "error"
+	// Search for minimal "error", only column 2 depends on x
 	Real const start{ 1.q / 5.q };
 	Real const end{ 1.q };
-	x = (start + end) / 2;
-	Real const span = std::abs(end - x);
-	uint8_t loop{ 1 };
-	do
-	{
-		int8_t index{ 0 };
-		Real min_error{ 1e20 };
-		Real const h = span * std::pow(4, -loop);
-		for (int8_t i{ -3 };i <= 3;++i)
+	GaussJordan::ColumnError objective(matrix, equal, 2,
+		[](Real const& t, std::vector<Real>& data)
 		{
-			Real t = x + h * i;
-			matrix.set_column(2, { 2, 2 * t, 2 * t * t, 2 * t * t * t, 2 * t * t * t * t });
-			auto result = GaussJordan::Solve(matrix, equal);
-			Real error = GaussJordan::ErrorEstimate(matrix, equal, result);
-			if (error < min_error)
-			{
-				index = i;
-				min_error = error;
-			}
-		}
-		x += index * h;
-		if ((min_error < numeric_epsilon) || (h < numeric_epsilon * 2))
-			break;
-	} while (++loop < 100);
+			data = { 2, 2 * t, 2 * t * t, 2 * t * t * t, 2 * t * t * t * t };
+		});
+	x = GaussJordan::Minimize(objective, start, end, numeric_epsilon * 2).parameter;
+	matrix.set_column(2, { 2, 2 * x, 2 * x * x, 2 * x * x * x, 2 * x * x * x * x });
 
 	auto result = GaussJordan::Solve(matrix, equal);
 	std::cout << std::setprecision(20) << "x = " << x << "\n";
@@ -0,0 +1,761 @@
+// Copyright (c) 2024 Thomas Klietsch, all rights reserved.
+//
+// Licensed under the GNU Lesser General Public License, version 3.0 or later
+//
+// This program is free software: you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation, either version 3 of
+// the License, or ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General
+// Public License along with this program.If not, see < https://www.gnu.org/licenses/>. 
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "./gauss_jordan.hpp"
+
+// Defined in test_link.cpp
+std::vector<double> LinkedSolve();
+
+// Regression tests, prints each failed check and
+// returns the number of failures
+namespace
+{
+
+	// Fixed size systems solve in constant evaluation, these fail to compile otherwise
+	constexpr double Distance(
+		std::optional<std::array<double, 2>> const& result,
+		std::array<double, 2> const& expected)
+	{
+		if (!result)
+			return 1;
+
+		double distance{ 0 };
+		for (std::size_t i{ 0 }; i < 2; ++i)
+			distance = std::max(distance, ((*result)[i] > expected[i]) ? (*result)[i] - expected[i] : expected[i] - (*result)[i]);
+		return distance;
+	};
+
+	// Zero at [0,0], so the rows are reordered
+	static_assert(GaussJordan::Solve(GaussJordan::FixedMatrix<3, 3, double>({ 0, 1, 0, 2, 0, 0, 0, 0, 4 }), std::array<double, 3>{ 1, 2, 8 })
+		== std::array<double, 3>{ 1, 1, 2 });
+	// Overdetermined, the diagonal method uses the first two rows
+	static_assert(GaussJordan::Solve(GaussJordan::FixedMatrix<3, 2, double>({ 1, 0, 0, 2, 5, 5 }), std::array<double, 3>{ 3, 4, 100 })
+		== std::array<double, 2>{ 3, 2 });
+	static_assert(Distance(GaussJordan::Solve(GaussJordan::FixedMatrix<2, 2, double>({ 1, 2, 3, 4 }), std::array<double, 2>{ 5, 6 },
+		magnitude_zero_v<double>, GaussJordan::Pivot::Partial), { -4, 4.5 }) < 1e-12);
+	static_assert(!GaussJordan::Solve(GaussJordan::FixedMatrix<2, 2, double>({ 1, 2, 2, 4 }), std::array<double, 2>{ 1, 1 }));
+
+	std::size_t failures{ 0 };
+
+	void Check(
+		bool const& condition,
+		std::string_view const& name)
+	{
+		if (condition)
+			return;
+
+		std::cout << "FAILED: " << name << "\n";
+		++failures;
+	};
+
+	// Well conditioned n x n matrix, with a zero at [1,1] so the diagonal method reorders
+	GaussJordan::Matrix<double> TestMatrix(
+		std::size_t const& n)
+	{
+		GaussJordan::Matrix<double> matrix(n, n);
+		for (std::size_t i{ 0 }; i < n; ++i)
+			for (std::size_t j{ 0 }; j < n; ++j)
+				matrix(i, j) = std::sin(1.0 + 7.3 * i * i + 3.1 * j * j * j + i * j) + ((i == j) ? 4 : 0);
+		matrix(1, 1) = 0;
+
+		return matrix;
+	};
+
+	// The rows for a non-zero diagonal are found in polynomial time, large dense
+	// matrices with a zero on the diagonal used to take exponential time.
+	// The chosen rows are the first combination the earlier search found
+	void TestSearchDiagonal()
+	{
+		GaussJordan::Matrix<double> const matrix = TestMatrix(200);
+		std::vector<double> const equal(200, 1.0);
+		GaussJordan::Stats<double> stats;
+		GaussJordan::Workspace<double> workspace;
+		workspace.stats = &stats;
+		std::vector<double> result;
+		Check(GaussJordan::Solve(matrix, equal, workspace, result) && stats.reordered
+			&& (GaussJordan::ErrorEstimate(matrix, equal, result) < 1e-6), "Solve reorders a large dense matrix");
+
+		GaussJordan::Matrix<double> small(3, 3);
+		for (std::size_t i{ 0 }; i < 3; ++i)
+			for (std::size_t j{ 0 }; j < 3; ++j)
+				small(i, j) = 1 + i + 2 * j * j;
+		small(0, 0) = 0;
+		Check(GaussJordan::Solve(small, std::vector<double>(3, 1.0), workspace, result)
+			&& (workspace.origin[0] == 2) && (workspace.origin[1] == 1) && (workspace.origin[2] == 0), "Search keeps the earlier row choice");
+	};
+
+	// Same method as Solve of a Matrix, so the same result
+	void TestFixedMatrix()
+	{
+		GaussJordan::Matrix<double> const matrix = TestMatrix(5);
+		GaussJordan::FixedMatrix<5, 5, double> fixed;
+		std::array<double, 5> equal{};
+		for (std::size_t i{ 0 }; i < 5; ++i)
+		{
+			for (std::size_t j{ 0 }; j < 5; ++j)
+				fixed(i, j) = matrix(i, j);
+			equal[i] = std::cos(1.0 * i);
+		}
+
+		std::optional<std::array<double, 5>> const result = GaussJordan::Solve(fixed, equal);
+		std::vector<double> const expected = GaussJordan::Solve(matrix, std::vector<double>(equal.begin(), equal.end()));
+		Check(result && std::equal(result->begin(), result->end(), expected.begin(), expected.end()), "FixedMatrix matches Matrix");
+	};
+
+	// More right hand sides than rows, each must match a single right hand side solve
+	void TestSolveMatrix()
+	{
+		std::size_t constexpr n{ 4 };
+		std::size_t constexpr n_right{ 6 };
+		GaussJordan::Matrix<double> const matrix = TestMatrix(n);
+		GaussJordan::Matrix<double> equal(n, n_right);
+		for (std::size_t i{ 0 }; i < n; ++i)
+			for (std::size_t j{ 0 }; j < n_right; ++j)
+				equal(i, j) = std::cos(1.0 + i + 2.0 * j);
+
+		for (GaussJordan::Pivot const pivot : { GaussJordan::Pivot::Diagonal, GaussJordan::Pivot::Partial, GaussJordan::Pivot::Full })
+		{
+			GaussJordan::Matrix<double> const result = GaussJordan::Solve(matrix, equal, 1e-9, pivot);
+			Check(result.size() == std::tuple<std::size_t, std::size_t>{ n, n_right }, "Solve with k > n right hand sides, size");
+
+			bool same{ true };
+			for (std::size_t j{ 0 }; j < n_right; ++j)
+			{
+				std::vector<double> column(n);
+				for (std::size_t i{ 0 }; i < n; ++i)
+					column[i] = equal(i, j);
+				std::vector<double> const single = GaussJordan::Solve(matrix, column, 1e-9, pivot);
+				for (std::size_t i{ 0 }; i < n; ++i)
+					same &= (single.size() == n) && (single[i] == result(i, j));
+			}
+			Check(same, "Solve with k > n right hand sides, matches single solves");
+		}
+
+		GaussJordan::Matrix<double> wrong_rows(n + 1, n_right);
+		Check(!GaussJordan::Solve(matrix, wrong_rows).is_valid(), "Solve rejects right hand sides with wrong row count");
+
+		GaussJordan::Matrix<double> not_finite(equal);
+		not_finite(2, 5) = NaN_v<double>;
+		Check(!GaussJordan::Solve(matrix, not_finite).is_valid(), "Solve rejects non-finite right hand sides");
+	};
+
+	// Systems of several sizes, some reordered and some singular,
+	// the batch must give exactly the results of Solve
+	void TestSolveBatch()
+	{
+		std::vector<GaussJordan::Matrix<double>> matrices;
+		std::vector<std::vector<double>> equals;
+		for (std::size_t k{ 0 }; k < 300; ++k)
+		{
+			std::size_t const n = 2 + k % 7;
+			GaussJordan::Matrix<double> matrix = TestMatrix(n);
+			if (k % 3)
+				matrix(1, 1) = 1 + 0.01 * k;
+			if (k % 37 == 0)
+				matrix.set_row(0, std::vector<double>(n, 0.0));
+			matrices.push_back(matrix);
+			equals.push_back(std::vector<double>(n, std::cos(1.0 * k)));
+		}
+
+		std::vector<std::vector<double>> results;
+		GaussJordan::SolveBatch(std::span<GaussJordan::Matrix<double> const>(matrices), std::span<std::vector<double> const>(equals), results);
+
+		bool same{ results.size() == matrices.size() };
+		for (std::size_t i{ 0 }; same && (i < matrices.size()); ++i)
+			same = (results[i] == GaussJordan::Solve(matrices[i], equals[i]));
+		Check(same, "SolveBatch matches Solve");
+
+		for (auto const pivot : { GaussJordan::Pivot::Partial, GaussJordan::Pivot::Full })
+		{
+			GaussJordan::SolveBatch(std::span<GaussJordan::Matrix<double> const>(matrices), std::span<std::vector<double> const>(equals), results,
+				magnitude_zero_v<double>, pivot);
+
+			same = (results.size() == matrices.size());
+			for (std::size_t i{ 0 }; same && (i < matrices.size()); ++i)
+				same = (results[i] == GaussJordan::Solve(matrices[i], equals[i], magnitude_zero_v<double>, pivot));
+			Check(same, "SolveBatch with pivoting matches Solve");
+		}
+
+	};
+
+	// Overdetermined, with zeros that move between points, so the rows chosen
+	// for the diagonal change and the row order kept between points matters
+	void TestSweep()
+	{
+		GaussJordan::Matrix<double> matrix(6, 4);
+		std::vector<double> equal(6);
+		auto const build = [](double const& parameter, GaussJordan::Matrix<double>& system, std::vector<double>& values)
+			{
+				std::size_t const shift = static_cast<std::size_t>(parameter * 100 + 0.5) % 3;
+				for (std::size_t i{ 0 }; i < 6; ++i)
+				{
+					for (std::size_t j{ 0 }; j < 4; ++j)
+					{
+						bool const zero = ((i + shift) % 6 == j) || ((j == 0) && (i < 2));
+						system(i, j) = zero ? 0 : std::sin(parameter * (1 + i) + 3.1 * j * j + i * j);
+					}
+					values[i] = std::cos(parameter + i);
+				}
+			};
+
+		std::vector<std::vector<GaussJordan::SweepPoint<double>>> sweeps;
+		for (std::size_t const n_threads : { 1, 3, 8 })
+		{
+			GaussJordan::ThreadPool pool(n_threads);
+			sweeps.push_back(GaussJordan::Sweep<double>(pool, matrix, equal, build, 0.01, 0.01, 500));
+		}
+
+		bool same{ true };
+		for (std::size_t i{ 0 }; same && (i < 500); ++i)
+			for (auto const& sweep : sweeps)
+				same = same && (sweep[i].result == sweeps[0][i].result);
+		Check(same, "Sweep does not depend on the threads");
+	};
+
+	// The second column is 1e-3 away from the span of the first,
+	// both methods reject it for a larger epsilon and accept it for a smaller one
+	void TestLeastSquares()
+	{
+		GaussJordan::Matrix<double> matrix(3, 2);
+		matrix(0, 0) = 1;
+		matrix(0, 1) = 1;
+		matrix(1, 1) = 1e-3;
+		std::vector<double> const equal{ 2, 1e-3, 0 };
+
+		for (auto const method : { GaussJordan::LeastSquares::QR, GaussJordan::LeastSquares::NormalEquations })
+		{
+			Check(GaussJordan::SolveLeastSquares(matrix, equal, 1e-2, method).empty(), "SolveLeastSquares rejects below epsilon");
+
+			std::vector<double> const result = GaussJordan::SolveLeastSquares(matrix, equal, 1e-4, method);
+			Check((result.size() == 2) && (std::abs(result[0] - 1) < 1e-6) && (std::abs(result[1] - 1) < 1e-6),
+				"SolveLeastSquares accepts above epsilon");
+		}
+	};
+
+	// Five point Laplacian on a grid, plus extra rows when overdetermined,
+	// solved under both column orderings
+	void TestSparseFactorization()
+	{
+		std::size_t const side{ 12 };
+		std::size_t const n{ side * side };
+		for (std::size_t const extra : { 0, 5 })
+		{
+			std::vector<GaussJordan::SparseMatrix<double>::Entry> entries;
+			GaussJordan::Matrix<double> dense(n + extra, n);
+			auto const add = [&](std::size_t const row, std::size_t const column, double const value)
+				{
+					entries.push_back({ row, column, value });
+					dense(row, column) += value;
+				};
+			for (std::size_t i{ 0 }; i < n; ++i)
+			{
+				add(i, i, 4 + 0.01 * i);
+				if (i % side)
+					add(i, i - 1, -1);
+				if ((i + 1) % side)
+					add(i, i + 1, -1);
+				if (i >= side)
+					add(i, i - side, -1);
+				if (i + side < n)
+					add(i, i + side, -1);
+			}
+			for (std::size_t k{ 0 }; k < extra; ++k)
+				add(n + k, 17 * k + 3, 1);
+
+			std::vector<double> equal(n + extra);
+			for (std::size_t i{ 0 }; i < n + extra; ++i)
+				equal[i] = std::cos(1.0 * i);
+			// The extra rows are consistent with the square system
+			std::vector<double> const exact = GaussJordan::Solve(dense, equal, magnitude_zero_v<double>, GaussJordan::Pivot::Partial);
+			for (std::size_t k{ 0 }; k < extra; ++k)
+				equal[n + k] = exact.empty() ? 0 : exact[17 * k + 3];
+
+			GaussJordan::SparseMatrix<double> const matrix(n + extra, n, entries);
+			std::size_t non_zeros[2]{};
+			for (auto const ordering : { GaussJordan::Ordering::Natural, GaussJordan::Ordering::MinimumDegree })
+			{
+				GaussJordan::SparseFactorization<double> const factorization(matrix, magnitude_zero_v<double>, ordering);
+				std::vector<double> const result = factorization.solve(equal);
+				Check(factorization.is_valid() && (result.size() == n) && (GaussJordan::ErrorEstimate(dense, equal, result) < 1e-10),
+					"SparseFactorization residual");
+				non_zeros[static_cast<std::size_t>(ordering)] = factorization.non_zeros();
+			}
+			Check(non_zeros[1] < non_zeros[0], "Minimum degree ordering reduces fill-in");
+		}
+	};
+
+	// Blocking into panels and tiles must not change the factorization
+	void TestFactorizationBlocking()
+	{
+		for (std::size_t const n_rows : { 100, 120 })
+		{
+			GaussJordan::Matrix<double> matrix(n_rows, 100);
+			std::vector<double> equal(n_rows);
+			for (std::size_t i{ 0 }; i < n_rows; ++i)
+			{
+				for (std::size_t j{ 0 }; j < 100; ++j)
+					matrix(i, j) = std::sin(1.0 + 7.3 * i * i + 3.1 * j * j * j + i * j) + ((i == j) ? 4 : 0);
+				equal[i] = std::cos(1.0 * i);
+			}
+			matrix(1, 1) = 0;
+
+			for (auto const pivot : { GaussJordan::Pivot::Diagonal, GaussJordan::Pivot::Partial })
+			{
+				// Unblocked, a single panel of all columns
+				std::vector<double> const expected = GaussJordan::Factorization<double>(matrix, magnitude_zero_v<double>, pivot, { 100, 100 }).solve(equal);
+
+				bool same{ expected.size() == 100 };
+				for (GaussJordan::Blocking const blocking : { GaussJordan::Blocking{}, GaussJordan::Blocking{ 1, 1 }, GaussJordan::Blocking{ 7, 13 } })
+					same = same && (GaussJordan::Factorization<double>(matrix, magnitude_zero_v<double>, pivot, blocking).solve(equal) == expected);
+				Check(same, "Blocked Factorization matches unblocked");
+			}
+		}
+	};
+
+	// Column updates of a factorization, nearly dependent on another column,
+	// must solve about as accurately as a new factorization of the updated matrix.
+	// That may itself be less accurate, as the diagonal method does not pivot
+	void TestFactorizationUpdate()
+	{
+		// Uniform in [-1, 1), the same on every platform
+		uint64_t state{ 5 };
+		auto const random = [&]
+			{
+				state = state * 6364136223846793005u + 1442695040888963407u;
+				return static_cast<double>(state >> 11) * 0x1p-52 - 1;
+			};
+
+		std::size_t const n{ 300 };
+		GaussJordan::Matrix<double> matrix(n, n);
+		std::vector<double> equal(n);
+		for (std::size_t i{ 0 }; i < n; ++i)
+		{
+			for (std::size_t j{ 0 }; j < n; ++j)
+				matrix(i, j) = random() + ((i == j) ? 4 : 0);
+			equal[i] = random();
+		}
+
+		GaussJordan::Factorization<double> factorization(matrix);
+		bool close{ factorization.is_valid() };
+		std::array<std::pair<std::size_t, double>, 6> constexpr updates{ { { 150, 1e-3 }, { 7, 1.0 }, { 299, 1e-1 }, { 42, 1e-2 }, { 150, 3e-3 }, { 100, 1e-3 } } };
+		for (auto const& [column, distance] : updates)
+		{
+			// Column 3, moved by distance
+			std::vector<double> data(n);
+			for (std::size_t i{ 0 }; i < n; ++i)
+				data[i] = matrix(i, 3) + distance * random();
+
+			matrix.set_column(column, data);
+			close = close && factorization.update_column(column, data);
+
+			std::vector<double> const result = factorization.solve(equal);
+			std::vector<double> const expected = GaussJordan::Factorization<double>(matrix).solve(equal);
+			double largest{ 0 };
+			double difference{ 0 };
+			for (std::size_t i{ 0 }; close && (i < n); ++i)
+			{
+				largest = std::max(largest, std::abs(expected[i]));
+				difference = std::max(difference, std::abs(result[i] - expected[i]));
+			}
+			close = close && (result.size() == n) && (difference <= 1e-8 * largest)
+				&& (GaussJordan::ErrorEstimate(matrix, equal, result) <= 10 * GaussJordan::ErrorEstimate(matrix, equal, expected));
+		}
+		Check(close, "Factorization update is as accurate as a new factorization");
+
+		// Well separated updates under each pivot method, full pivoting maps the
+		// column through its swaps, overdetermined matrices have extra rows
+		for (std::size_t const n_rows : { 40, 50 })
+			for (auto const pivot : { GaussJordan::Pivot::Diagonal, GaussJordan::Pivot::Partial, GaussJordan::Pivot::Full })
+			{
+				GaussJordan::Matrix<double> small(n_rows, 40);
+				for (std::size_t i{ 0 }; i < n_rows; ++i)
+					for (std::size_t j{ 0 }; j < 40; ++j)
+						small(i, j) = random() + ((i == j) ? 4 : 0);
+
+				GaussJordan::Factorization<double> updated(small, magnitude_zero_v<double>, pivot);
+				bool same{ updated.is_valid() };
+				for (std::size_t const column : { 5, 39, 0, 5 })
+				{
+					std::vector<double> data(n_rows);
+					for (std::size_t i{ 0 }; i < n_rows; ++i)
+						data[i] = random() + ((i == column) ? 4 : 0);
+					small.set_column(column, data);
+					same = same && updated.update_column(column, data);
+
+					// Consistent, so the kept pivot rows give the same solution
+					std::vector<double> small_equal(n_rows);
+					for (std::size_t i{ 0 }; i < n_rows; ++i)
+						for (std::size_t j{ 0 }; j < 40; ++j)
+							small_equal[i] += small(i, j) * std::sin(j + 1.0);
+
+					std::vector<double> const result = updated.solve(small_equal);
+					std::vector<double> const expected = GaussJordan::Factorization<double>(small, magnitude_zero_v<double>, pivot).solve(small_equal);
+					same = same && (result.size() == 40) && (expected.size() == 40);
+					for (std::size_t i{ 0 }; same && (i < 40); ++i)
+						same = (std::abs(result[i] - expected[i]) <= 1e-12 * (1 + std::abs(expected[i])));
+				}
+				Check(same, "Factorization update matches a new factorization");
+			}
+	};
+
+	// Known minima, also where the function is not finite on part of the interval.
+	// A flat minimum is only found to about the square root of the precision
+	void TestMinimize()
+	{
+		auto const parabola = [](double const& x) { return (x - 0.3) * (x - 0.3) + 1; };
+		auto const cut = [](double const& x) { return (x < 0.8) ? std::cos(3 * x) : std::numeric_limits<double>::quiet_NaN(); };
+		double const pi = std::acos(-1.0);
+
+		GaussJordan::Minimum<double> minimum = GaussJordan::Minimize(parabola, 0.0, 1.0, 1e-10);
+		Check((std::abs(minimum.parameter - 0.3) < 1e-7) && (minimum.value == parabola(minimum.parameter)) && (minimum.evaluations < 50),
+			"Minimize finds the minimum of a parabola");
+		minimum = GaussJordan::Minimize(cut, 0.0, 2.0, 1e-10);
+		Check(std::abs(minimum.parameter - 0.8) < 1e-6, "Minimize ignores values that are not finite");
+		minimum = GaussJordan::Minimize(cut, 0.5, 0.7, 1e-10);
+		Check(std::abs(minimum.parameter - 0.7) < 1e-6, "Minimize finds a minimum at the bound");
+		Check(std::isnan(GaussJordan::Minimize(parabola, 1.0, 0.0).parameter), "Minimize rejects an empty interval");
+
+		GaussJordan::ThreadPool pool(3);
+		auto const wave = [](double const& x, std::size_t const&) { return std::cos(x); };
+		minimum = GaussJordan::Minimize(pool, wave, 2.0, 4.0, 1e-10);
+		Check((std::abs(minimum.parameter - pi) < 1e-7) && (minimum.value == std::cos(minimum.parameter)),
+			"Parallel Minimize finds the minimum of a wave");
+		Check(std::isnan(GaussJordan::Minimize(pool, wave, 4.0, 2.0).parameter), "Parallel Minimize rejects an empty interval");
+
+		// ColumnError agrees with solving each matrix from scratch
+		GaussJordan::Matrix<double> matrix = TestMatrix(20);
+		std::vector<double> const equal(20, 1.0);
+		auto const column = [](double const& t, std::vector<double>& data)
+			{
+				for (std::size_t i{ 0 }; i < data.size(); ++i)
+					data[i] = std::sin(t * (1 + i)) + ((i == 2) ? 4 : 0);
+			};
+		GaussJordan::ColumnError objective(matrix, equal, 2, column);
+		bool same{ true };
+		for (double const t : { 0.1, 0.5, 0.2, 0.9 })
+		{
+			std::vector<double> data(20);
+			column(t, data);
+			matrix.set_column(2, data);
+			double const expected = GaussJordan::ErrorEstimate(matrix, equal, GaussJordan::Solve(matrix, equal));
+			double const error = objective(t);
+			same = same && (std::abs(error - expected) <= 1e-12);
+		}
+		Check(same, "ColumnError is the error of a new solution");
+	};
+
+	// True if the results agree to tolerance, relative to the largest value
+	bool Close(
+		std::vector<double> const& result,
+		std::vector<double> const& expected,
+		double const& tolerance)
+	{
+		if (result.empty() || (result.size() != expected.size()))
+			return false;
+
+		double largest{ 0 };
+		double difference{ 0 };
+		for (std::size_t i{ 0 }; i < result.size(); ++i)
+		{
+			largest = std::max(largest, std::abs(expected[i]));
+			difference = std::max(difference, std::abs(result[i] - expected[i]));
+		}
+
+		return difference <= tolerance * largest;
+	};
+
+	// The structured solvers agree with Solve of the dense matrix
+	void TestStructuredSolve()
+	{
+		std::size_t const n{ 10 };
+		std::vector<double> equal(n);
+		std::vector<double> nodes(n);
+		for (std::size_t i{ 0 }; i < n; ++i)
+		{
+			equal[i] = std::cos(1.0 + 2.0 * i);
+			nodes[i] = std::cos((2.0 * i + 1) * std::acos(-1.0) / (2 * n)) + 0.1;
+		}
+
+		GaussJordan::Matrix<double> columns(n, n);
+		GaussJordan::Matrix<double> rows(n, n);
+		for (std::size_t i{ 0 }; i < n; ++i)
+			for (std::size_t j{ 0 }; j < n; ++j)
+			{
+				columns(i, j) = std::pow(nodes[j], static_cast<double>(i));
+				rows(i, j) = std::pow(nodes[i], static_cast<double>(j));
+			}
+		Check(Close(GaussJordan::SolveVandermonde(nodes, equal), GaussJordan::Solve(columns, equal, magnitude_zero_v<double>, GaussJordan::Pivot::Partial), 1e-9),
+			"SolveVandermonde agrees with Solve");
+		Check(Close(GaussJordan::SolveVandermondeRows(nodes, equal), GaussJordan::Solve(rows, equal, magnitude_zero_v<double>, GaussJordan::Pivot::Partial), 1e-9),
+			"SolveVandermondeRows agrees with Solve");
+
+		std::vector<double> repeated(nodes);
+		repeated[3] = repeated[7];
+		Check(GaussJordan::SolveVandermonde(repeated, equal).empty() && GaussJordan::SolveVandermondeRows(repeated, equal).empty(),
+			"Vandermonde solvers reject equal nodes");
+
+		// Interleaved x and y, so the elimination has to pivot
+		std::vector<double> x(n);
+		std::vector<double> y(n);
+		GaussJordan::Matrix<double> cauchy(n, n);
+		for (std::size_t i{ 0 }; i < n; ++i)
+		{
+			x[i] = std::sin(3.0 * i);
+			y[i] = std::sin(3.0 * i + 1.5);
+		}
+		for (std::size_t i{ 0 }; i < n; ++i)
+			for (std::size_t j{ 0 }; j < n; ++j)
+				cauchy(i, j) = 1 / (x[i] - y[j]);
+		Check(Close(GaussJordan::SolveCauchy(x, y, equal), GaussJordan::Solve(cauchy, equal, magnitude_zero_v<double>, GaussJordan::Pivot::Partial), 1e-9),
+			"SolveCauchy agrees with Solve");
+
+		std::vector<double> same_x(x);
+		same_x[5] = same_x[2];
+		Check(GaussJordan::SolveCauchy(same_x, y, equal).empty(), "SolveCauchy rejects a singular matrix");
+
+		// Not symmetric
+		std::vector<double> diagonal(2 * n - 1);
+		GaussJordan::Matrix<double> toeplitz(n, n);
+		for (std::size_t k{ 0 }; k < diagonal.size(); ++k)
+			diagonal[k] = std::sin(1.0 + 2.3 * k) + ((k == n - 1) ? 3 : 0);
+		for (std::size_t i{ 0 }; i < n; ++i)
+			for (std::size_t j{ 0 }; j < n; ++j)
+				toeplitz(i, j) = diagonal[n - 1 + i - j];
+		Check(Close(GaussJordan::SolveToeplitz(diagonal, equal), GaussJordan::Solve(toeplitz, equal, magnitude_zero_v<double>, GaussJordan::Pivot::Partial), 1e-9),
+			"SolveToeplitz agrees with Solve");
+
+		// A zero on the main diagonal makes the first leading submatrix singular
+		diagonal[n - 1] = 0;
+		Check(GaussJordan::SolveToeplitz(diagonal, equal).empty(), "SolveToeplitz rejects a singular leading submatrix");
+	};
+
+	// Refinement in double of a float factorization reaches the accuracy of
+	// a double solve, which a float solve alone does not
+	void TestSolveRefined()
+	{
+		GaussJordan::Matrix<double> const matrix = TestMatrix(30);
+		std::vector<double> equal(30);
+		for (std::size_t i{ 0 }; i < 30; ++i)
+			equal[i] = std::cos(1.0 + i);
+
+		std::vector<float> const low = GaussJordan::Solve(GaussJordan::Matrix<float>(matrix), std::vector<float>(equal.begin(), equal.end()));
+		std::vector<double> const direct(low.begin(), low.end());
+		std::vector<double> const expected = GaussJordan::Solve(matrix, equal);
+		std::vector<double> const refined = GaussJordan::SolveRefined<float>(matrix, equal);
+
+		double const direct_error = GaussJordan::ErrorEstimate(matrix, equal, direct);
+		double const error = GaussJordan::ErrorEstimate(matrix, equal, refined);
+		Check((error < 1e-3 * direct_error) && (error <= 10 * GaussJordan::ErrorEstimate(matrix, equal, expected)),
+			"SolveRefined improves on a float solve");
+		Check(Close(refined, expected, 1e-12), "SolveRefined agrees with a double solve");
+	};
+
+	// Stats of a solve into a workspace, from values in row order
+	GaussJordan::Stats<double> SolveStats(
+		std::size_t const& n,
+		std::vector<double> const& values,
+		std::vector<double> const& equal,
+		GaussJordan::Pivot const& pivot = GaussJordan::Pivot::Diagonal)
+	{
+		GaussJordan::Matrix<double> matrix(values.size() / n, n);
+		for (std::size_t i{ 0 }; i < values.size(); ++i)
+			matrix(i / n, i % n) = values[i];
+
+		GaussJordan::Stats<double> stats;
+		stats.failure = GaussJordan::Failure::NonFiniteResult;
+		GaussJordan::Workspace<double> workspace;
+		workspace.stats = &stats;
+		std::vector<double> result;
+		GaussJordan::Solve(matrix, equal, workspace, result, magnitude_zero_v<double>, pivot);
+
+		return stats;
+	};
+
+	// Each failure is reported, and the fields of a successful solve are reset
+	void TestStats()
+	{
+		using GaussJordan::Failure;
+
+		GaussJordan::Stats<double> stats = SolveStats(2, { 2, 1, 1, 2 }, { 3, 3 });
+		Check((stats.failure == Failure::None) && !stats.reordered && !stats.cached && (stats.pivot_growth >= 1),
+			"Stats of a solve without reordering");
+		stats = SolveStats(2, { 0, 1, 2, 0 }, { 1, 4 });
+		Check((stats.failure == Failure::None) && stats.reordered && (stats.searches > 0), "Stats of a reordered solve");
+
+		Check(SolveStats(2, { 1, 2, 3, 4 }, { 1, 2, 3 }).failure == Failure::InvalidInput, "Stats report InvalidInput");
+		Check(SolveStats(3, { 1, 2, 3, 4, 5, 6 }, { 1, 2 }).failure == Failure::InvalidInput, "Stats report an underdetermined matrix");
+		Check(SolveStats(2, { 1, 0, 2, 0 }, { 1, 2 }).failure == Failure::ZeroColumn, "Stats report ZeroColumn");
+		Check(SolveStats(3, { 1, 1, 1, 1, 0, 0, 1, 0, 0 }, { 1, 2, 3 }).failure == Failure::NoDiagonal, "Stats report NoDiagonal");
+		Check(SolveStats(2, { 1, 2, 2, 4 }, { 1, 2 }, GaussJordan::Pivot::Partial).failure == Failure::SingularPivot, "Stats report SingularPivot");
+		Check(SolveStats(2, { 1e-6, 1, 1e305, 1 }, { 1, 2 }).failure == Failure::NonFiniteScalar, "Stats report NonFiniteScalar");
+		Check(SolveStats(2, { 1e-6, 0, 0, 1 }, { 1e305, 1 }).failure == Failure::NonFiniteResult, "Stats report NonFiniteResult");
+
+		// The second solve uses the cached row order
+		GaussJordan::Matrix<double> const matrix = TestMatrix(5);
+		std::vector<double> const equal(5, 1.0);
+		GaussJordan::PivotCache cache;
+		GaussJordan::Workspace<double> workspace;
+		workspace.stats = &stats;
+		workspace.cache = &cache;
+		std::vector<double> result;
+		GaussJordan::Solve(matrix, equal, workspace, result);
+		bool const searched = stats.reordered && !stats.cached;
+		GaussJordan::Solve(matrix, equal, workspace, result);
+		Check(searched && stats.reordered && stats.cached && (cache.hits == 1), "Stats report a cached row order");
+	};
+
+	template<typename T>
+	concept Writable = requires (GaussJordan::Writer& writer, T const& value) { writer << value; };
+
+	static_assert(Writable<bool> && Writable<signed char> && Writable<unsigned char> && Writable<char8_t> && Writable<long double>);
+	static_assert(!Writable<wchar_t> && !Writable<char16_t> && !Writable<char32_t>);
+
+	// Writer gives the same text as std::ostream with default formatting
+	void TestWriter()
+	{
+		std::ostringstream expected;
+		std::ostringstream stream;
+		{
+			GaussJordan::Writer writer(stream);
+			writer << true << ' ' << false << ' ' << 'a' << static_cast<signed char>('b') << static_cast<unsigned char>('c')
+				<< ' ' << -42 << ' ' << uint64_t(-1) << ' ' << 0.1 << ' ' << -1e-20 << ' ' << 123456789.0 << ' ' << 2.5f << std::string_view(" end");
+		}
+		expected << true << ' ' << false << ' ' << 'a' << static_cast<signed char>('b') << static_cast<unsigned char>('c')
+			<< ' ' << -42 << ' ' << uint64_t(-1) << ' ' << 0.1 << ' ' << -1e-20 << ' ' << 123456789.0 << ' ' << 2.5f << " end";
+		Check(stream.str() == expected.str(), "Writer formats as std::ostream");
+
+		std::ostringstream text;
+		{
+			GaussJordan::Writer writer(text);
+			writer << u8'x';
+		}
+		Check(text.str() == "x", "Writer writes char8_t as a character");
+	};
+
+	// Sweep file whose header has the given counts, and room for a few records
+	std::vector<std::byte> SweepFile(
+		uint64_t const& n_values,
+		uint64_t const& n_records)
+	{
+		GaussJordan::SweepHeader header;
+		header.value_size = sizeof(double);
+		header.value_digits = std::numeric_limits<double>::digits;
+		header.n_values = n_values;
+		header.n_records = n_records;
+
+		std::vector<std::byte> data(header.offset + 4 * 3 * sizeof(double));
+		std::memcpy(data.data(), &header, sizeof(header));
+
+		return data;
+	};
+
+	// Counts whose product wraps around must not pass the length check
+	void TestSweepView()
+	{
+		Check(GaussJordan::SweepView<double>(SweepFile(1, 4)).is_valid(), "SweepView accepts a valid header");
+		Check(!GaussJordan::SweepView<double>(SweepFile(1, 5)).is_valid(), "SweepView rejects a truncated file");
+		Check(!GaussJordan::SweepView<double>(SweepFile(uint64_t(-2), 1)).is_valid(), "SweepView rejects n_values near the maximum");
+		Check(!GaussJordan::SweepView<double>(SweepFile((uint64_t(1) << 62) - 2, 4)).is_valid(), "SweepView rejects a count that wraps around");
+		Check(!GaussJordan::SweepView<double>(SweepFile(1, uint64_t(-1) / 3 + 1)).is_valid(), "SweepView rejects n_records that wraps around");
+	};
+
+	// System file whose header has the given sizes, with data_size values after it
+	std::vector<std::byte> SystemFile(
+		uint64_t const& n_rows,
+		uint64_t const& n_columns,
+		std::size_t const& data_size)
+	{
+		GaussJordan::SystemHeader header;
+		header.value_size = sizeof(double);
+		header.value_digits = std::numeric_limits<double>::digits;
+		header.n_rows = n_rows;
+		header.n_columns = n_columns;
+
+		std::vector<std::byte> data(header.offset + data_size * sizeof(double));
+		std::memcpy(data.data(), &header, sizeof(header));
+
+		return data;
+	};
+
+	void TestSystemView()
+	{
+		// A written system reads back, a truncated copy of it does not
+		GaussJordan::Matrix<double> const matrix = TestMatrix(3);
+		std::vector<double> const equal{ 1, 2, 3 };
+		std::ostringstream stream;
+		Check(GaussJordan::WriteSystem(stream, matrix, equal), "WriteSystem");
+		std::string const bytes = stream.str();
+		std::vector<std::byte> data(bytes.size());
+		std::memcpy(data.data(), bytes.data(), bytes.size());
+
+		GaussJordan::Matrix<double> loaded;
+		std::vector<double> loaded_equal;
+		Check(GaussJordan::SystemView<double>(data).load(loaded, loaded_equal) && (loaded_equal == equal), "SystemView reads a written system");
+
+		data.pop_back();
+		Check(GaussJordan::SystemView<double>(data).matrix().empty(), "SystemView rejects a truncated file");
+
+		// Crafted sizes whose product, or n_columns + 1, wraps around
+		Check(GaussJordan::SystemView<double>(SystemFile(2, 3, 8)).matrix().size() == 6, "SystemView accepts a valid header");
+		Check(GaussJordan::SystemView<double>(SystemFile(1, uint64_t(-1), 8)).matrix().empty(), "SystemView rejects n_columns + 1 that wraps around");
+		Check(GaussJordan::SystemView<double>(SystemFile(uint64_t(1) << 62, 3, 8)).matrix().empty(), "SystemView rejects n_rows that wraps around");
+		Check(GaussJordan::SystemView<double>(SystemFile((uint64_t(1) << 63) + 1, 1, 8)).matrix().empty(), "SystemView rejects a product that wraps around");
+	};
+
+};
+
+int main()
+{
+	TestSearchDiagonal();
+	TestSolveMatrix();
+	TestFixedMatrix();
+	TestSolveBatch();
+	TestSweep();
+	TestLeastSquares();
+	TestSparseFactorization();
+	TestFactorizationBlocking();
+	TestFactorizationUpdate();
+	TestMinimize();
+	TestStructuredSolve();
+	TestSolveRefined();
+	TestStats();
+	TestWriter();
+	TestSweepView();
+	TestSystemView();
+	Check(LinkedSolve() == std::vector<double>{ 2, 1 }, "Header links into two translation units");
+
+	if (!failures)
+		std::cout << "All tests passed\n";
+
+	return static_cast<int>(failures);
+};
@@ -0,0 +1,31 @@
+// Copyright (c) 2024 Thomas Klietsch, all rights reserved.
+//
+// Licensed under the GNU Lesser General Public License, version 3.0 or later
+//
+// This program is free software: you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation, either version 3 of
+// the License, or ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General
+// Public License along with this program.If not, see < https://www.gnu.org/licenses/>. 
+
+#include <vector>
+
+#include "./gauss_jordan.hpp"
+
+// Second translation unit of the tests, the test build fails to link
+// if the header defines a function that is not inline
+std::vector<double> LinkedSolve()
+{
+	GaussJordan::Matrix<double> matrix(2, 2);
+	matrix(0, 1) = 1;
+	matrix(1, 0) = 2;
+
+	return GaussJordan::Solve(matrix, std::vector<double>{ 1, 4 });
+};